@@ -0,0 +1,195 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "corpus.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "random.h"
+
+static const std::vector<std::pair<std::string, Corpus::Type>> types{
+    {"ascii", Corpus::Type::Ascii},
+    {"cjk", Corpus::Type::Cjk},
+    {"invalid", Corpus::Type::Invalid},
+    {"long_lines", Corpus::Type::LongLines},
+    {"tabs", Corpus::Type::Tabs}};
+
+// Data is written in blocks, so huge corpora do not need huge memory
+static const size_t block_size = 1 << 20;
+
+static std::string typeName(Corpus::Type type) {
+  for (const auto &info : types) {
+    if (info.second == type) {
+      return info.first;
+    }
+  }
+  return "";
+}
+
+Corpus::Corpus(Type type, size_t size)
+    : type_name(typeName(type)), temporary(true) {
+  const char *tmp_dir = getenv("TMPDIR");
+  file_path =
+      std::string(tmp_dir ? tmp_dir : "/tmp") + "/mattext_corpus_XXXXXX";
+  int fd = mkstemp(&file_path[0]);
+  if (fd == -1) {
+    std::ostringstream err;
+    err << "Can't create corpus file: " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+  generate(type, size, fd);
+}
+
+Corpus::Corpus(Type type, size_t size, const std::string &path)
+    : file_path(path), type_name(typeName(type)), temporary(false) {
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    std::ostringstream err;
+    err << "Can't create file '" << path << "': " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+  generate(type, size, fd);
+}
+
+Corpus::~Corpus() {
+  if (temporary) {
+    unlink(file_path.c_str());
+  }
+}
+
+const std::string &Corpus::path() const {
+  return file_path;
+}
+
+const std::string &Corpus::name() const {
+  return type_name;
+}
+
+size_t Corpus::size() const {
+  return file_size;
+}
+
+Corpus::Type Corpus::getType(const std::string &name) {
+  for (const auto &info : types) {
+    if (info.first == name) {
+      return info.second;
+    }
+  }
+  throw std::runtime_error("Unknown corpus type '" + name
+                           + "', available types are " + getNames());
+}
+
+std::string Corpus::getNames() {
+  std::string names;
+
+  for (const auto &info : types) {
+    if (names.size()) {
+      names += ", ";
+    }
+    names += info.first;
+  }
+  return names;
+}
+
+size_t Corpus::parseSize(const std::string &value) {
+  char *end = nullptr;
+  size_t size = strtoull(value.c_str(), &end, 0);
+
+  switch (*end) {
+    case 'G':
+      size <<= 10;
+    // fall through
+    case 'M':
+      size <<= 10;
+    // fall through
+    case 'K':
+      size <<= 10;
+      ++end;
+      break;
+  }
+  if ((end == value.c_str()) || *end) {
+    throw std::runtime_error("Invalid size '" + value + "'");
+  }
+  return size;
+}
+
+void Corpus::generate(Type type, size_t size, int fd) {
+  Random random(size);
+  std::string data;
+  size_t line_len = 0;
+  // Percent of symbols which end lines
+  const uint32_t new_line_chance = (type == Type::LongLines) ? 0 : 2;
+  file_size = 0;
+
+  while (file_size < size) {
+    data.clear();
+
+    while ((data.size() < block_size) && (file_size + data.size() < size)) {
+      const uint32_t value = random.next();
+      const bool long_line_end =
+          (type == Type::LongLines) && (line_len >= 10000 + value % 10000);
+      if (line_len && ((value % 100 < new_line_chance) || long_line_end)) {
+        data += '\n';
+        line_len = 0;
+        continue;
+      }
+      ++line_len;
+
+      switch (type) {
+        case Type::Ascii:
+        case Type::LongLines:
+          data += (value % 20) ? static_cast<char>(0x20 + value % 95) : '\t';
+          break;
+        case Type::Tabs:
+          data += (value % 4) ? static_cast<char>(0x20 + value % 95) : '\t';
+          break;
+        case Type::Cjk: {
+          // U+4E00 - U+9FFF, three bytes in UTF-8
+          const uint32_t code = 0x4e00 + value % 0x5200;
+          data += static_cast<char>(0xe0 | (code >> 12));
+          data += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+          data += static_cast<char>(0x80 | (code & 0x3f));
+          break;
+        }
+        case Type::Invalid:
+          data += static_cast<char>((value % 4) ? 0x80 + value % 0x80
+                                                : 0x20 + value % 95);
+          break;
+      }
+    }
+
+    const ssize_t written = write(fd, data.data(), data.size());
+    if (written != static_cast<ssize_t>(data.size())) {
+      std::ostringstream err;
+      err << "Can't write corpus file '" << file_path
+          << "': " << strerror(errno);
+      close(fd);
+      throw std::runtime_error(err.str());
+    }
+    file_size += data.size();
+  }
+  close(fd);
+}
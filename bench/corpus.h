@@ -0,0 +1,52 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <string>
+
+// Synthetic input file. Temporary corpus is removed when object is destroyed.
+class Corpus {
+ public:
+  enum class Type { Ascii, Cjk, Invalid, LongLines, Tabs };
+
+  // Creates temporary file
+  Corpus(Type type, size_t size);
+  // Creates file with specified path, which is kept
+  Corpus(Type type, size_t size, const std::string &path);
+  ~Corpus();
+  const std::string &path() const;
+  const std::string &name() const;
+  size_t size() const;
+  static Type getType(const std::string &name);
+  static std::string getNames();
+  // Parses size with optional K, M or G suffix
+  static size_t parseSize(const std::string &value);
+
+ private:
+  std::string file_path;
+  std::string type_name;
+  size_t file_size;
+  bool temporary;
+
+  void generate(Type type, size_t size, int fd);
+};
@@ -0,0 +1,104 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "harness.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <stdexcept>
+#include "corpus.h"
+
+Harness::Harness(int argc, char *argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--min-time") && (i + 1 < argc)) {
+      min_time = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--corpus-size") && (i + 1 < argc)) {
+      corpus_size = Corpus::parseSize(argv[++i]);
+    } else if (argv[i][0] == '-') {
+      throw std::runtime_error(
+          std::string("Unknown option '") + argv[i]
+          + "', usage: mattext_bench [--min-time seconds] "
+            "[--corpus-size bytes] [filter ...]");
+    } else {
+      filters.push_back(argv[i]);
+    }
+  }
+  if (!corpus_size) {
+    throw std::runtime_error("Corpus size should be positive");
+  }
+}
+
+bool Harness::selected(const std::string &name) const {
+  if (filters.empty()) {
+    return true;
+  }
+  for (const auto &filter : filters) {
+    if (name.find(filter) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Harness::run(const std::string &name, Benchmark benchmark) {
+  if (!selected(name)) {
+    return;
+  }
+  Result result{name, 0, 0., {0, 0}};
+  const auto start = Clock::now();
+
+  // Warm up caches and allocations first
+  benchmark();
+  do {
+    const Work work = benchmark();
+    result.work.items += work.items;
+    result.work.bytes += work.bytes;
+    ++result.iterations;
+    result.seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+  } while (result.seconds < min_time);
+
+  fprintf(stderr, "%-40s %10.1f ns/item\n", name.c_str(),
+          result.seconds * 1e9 / std::max<size_t>(1, result.work.items));
+  results.push_back(result);
+}
+
+void Harness::report(FILE *out) const {
+  fprintf(out, "{\n  \"benchmarks\": [");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto &result = results[i];
+    fprintf(out,
+            "%s\n    {\"name\": \"%s\", \"iterations\": %zu, "
+            "\"seconds\": %.6f, \"items\": %zu, \"bytes\": %zu, "
+            "\"ns_per_item\": %.3f, \"items_per_second\": %.3f, "
+            "\"bytes_per_second\": %.3f}",
+            i ? "," : "", result.name.c_str(), result.iterations,
+            result.seconds, result.work.items, result.work.bytes,
+            result.seconds * 1e9 / std::max<size_t>(1, result.work.items),
+            result.work.items / result.seconds,
+            result.work.bytes / result.seconds);
+  }
+  fprintf(out, "\n  ]\n}\n");
+}
+
+size_t Harness::corpusSize() const {
+  return corpus_size;
+}
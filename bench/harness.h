@@ -0,0 +1,60 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stdio.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal benchmark runner. Benchmark is a function, that does some work and
+// returns amount of it, runner calls it until minimal time is spent.
+class Harness {
+ public:
+  struct Work {
+    size_t items;
+    size_t bytes;
+  };
+  using Benchmark = std::function<Work()>;
+
+  // Usage: mattext_bench [--min-time seconds] [--corpus-size bytes] [filter..]
+  Harness(int argc, char *argv[]);
+  void run(const std::string &name, Benchmark benchmark);
+  void report(FILE *out) const;
+  size_t corpusSize() const;
+
+ private:
+  struct Result {
+    std::string name;
+    size_t iterations;
+    double seconds;
+    Work work;
+  };
+  using Clock = std::chrono::steady_clock;
+  double min_time = 0.5;
+  size_t corpus_size = 1 << 20;
+  std::vector<std::string> filters;
+  std::vector<Result> results;
+
+  bool selected(const std::string &name) const;
+};
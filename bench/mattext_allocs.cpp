@@ -0,0 +1,164 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+// Turns pages with every animation in a headless terminal and fails when
+// animation ticks or page reads allocate memory after warm-up. Needs
+// mattext built with MATTEXT_COUNT_ALLOCS option.
+
+#include <ev++.h>
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "alloc_counter.h"
+#include "animation.h"
+#include "config.h"
+#include "corpus.h"
+#include "file_stream.h"
+#include "manager_interactive.h"
+#include "stats.h"
+#include "terminal_headless.h"
+
+static const char *usage =
+    "Usage: mattext_allocs [--pages number] [--corpus-size bytes]";
+
+// Both directions and all animation buffers are initialized during warm-up
+static const size_t warmup_pages = 4;
+
+struct Options {
+  size_t pages = 100;
+  size_t corpus_size = 1 << 16;
+};
+
+static std::vector<std::string> animationNames() {
+  std::vector<std::string> names;
+  std::istringstream stream(AnimationStore::getNames());
+  std::string name;
+
+  while (std::getline(stream, name, ',')) {
+    names.push_back(name.substr(name.find_first_not_of(' ')));
+  }
+  return names;
+}
+
+static void printTotals(const char *scope, const AllocTotals &totals) {
+  printf("  %-6s %8llu calls, %8llu allocations, max %llu per call\n", scope,
+         static_cast<unsigned long long>(totals.calls),
+         static_cast<unsigned long long>(totals.allocs),
+         static_cast<unsigned long long>(totals.max));
+}
+
+// Returns number of allocations after warm-up
+static uint64_t check(const Options &options, const Corpus &corpus,
+                      const std::string &animation) {
+  Config config;
+  config.files.push_back(corpus.path().c_str());
+  config.animation_next = animation;
+  config.animation_prev = animation;
+  config.delay = 0;
+  config.width = 80;
+  config.height = 24;
+  config.infinite = true;
+  config.stats = true;
+  Stats stats(config);
+  HeadlessTerminal terminal(config, stats);
+  FileStream file_stream(config, terminal, stats);
+  ManagerInteractive manager(config, file_stream, terminal, stats);
+  AllocTotals *tick = stats.getAllocTotals("tick." + animation);
+  AllocTotals *page = stats.getAllocTotals("page");
+  size_t pages_shown = 0;
+
+  manager.onPageShown([&]() {
+    // Stopping animation on exit calls this callback once more
+    if (++pages_shown > warmup_pages + options.pages) {
+      return;
+    }
+    if (pages_shown == warmup_pages) {
+      *tick = AllocTotals();
+      *page = AllocTotals();
+    }
+    if (pages_shown == warmup_pages + options.pages) {
+      terminal.press('q');
+      return;
+    }
+    // Every fourth page is read backward
+    terminal.press((pages_shown % 4 == 2) ? 'b' : 'f');
+  });
+  ev_run(EV_DEFAULT, 0);
+
+  printf("%s\n", animation.c_str());
+  printTotals("tick", *tick);
+  printTotals("page", *page);
+  return tick->allocs + page->allocs;
+}
+
+static Options parseOptions(int argc, char *argv[]) {
+  Options options;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if ((arg == "--pages") && (i + 1 < argc)) {
+      options.pages = atoi(argv[++i]);
+    } else if ((arg == "--corpus-size") && (i + 1 < argc)) {
+      options.corpus_size = Corpus::parseSize(argv[++i]);
+    } else {
+      throw std::runtime_error(usage);
+    }
+  }
+  return options;
+}
+
+int main(int argc, char *argv[]) {
+  if (!setlocale(LC_CTYPE, "C.UTF-8") && !setlocale(LC_CTYPE, "en_US.UTF-8")) {
+    fprintf(stderr, "Can't set UTF-8 locale\n");
+    return 1;
+  }
+
+  try {
+    if (!AllocCounter::isEnabled()) {
+      throw std::runtime_error(
+          "Allocation counter is disabled, configure mattext with "
+          "-DMATTEXT_COUNT_ALLOCS=ON");
+    }
+    const Options options = parseOptions(argc, argv);
+    Corpus corpus(Corpus::Type::Ascii, options.corpus_size);
+    uint64_t allocs = 0;
+
+    for (const auto &name : animationNames()) {
+      allocs += check(options, corpus, name);
+    }
+    if (allocs) {
+      fflush(stdout);
+      fprintf(stderr, "%llu allocations in steady state\n",
+              static_cast<unsigned long long>(allocs));
+      return 1;
+    }
+  } catch (std::exception &e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}
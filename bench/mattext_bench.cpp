@@ -0,0 +1,225 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include <ev++.h>
+#include <locale.h>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "animation.h"
+#include "config.h"
+#include "corpus.h"
+#include "file_cache.h"
+#include "file_io.h"
+#include "file_reader.h"
+#include "harness.h"
+#include "io_counters.h"
+#include "random.h"
+#include "stats.h"
+#include "terminal_headless.h"
+
+static void benchFileIO(Harness &harness, const Corpus &corpus) {
+  for (auto direction : {Direction::Forward, Direction::Backward}) {
+    const std::string name =
+        (direction == Direction::Forward) ? "forward" : "backward";
+
+    harness.run("file_io." + name + "." + corpus.name(),
+                [&corpus, direction]() {
+                  IoCounters counters;
+                  FileIO f(corpus.path().c_str(), counters);
+                  wchar_t symbol;
+                  size_t symbols = 0;
+
+                  f.newPage(direction);
+                  while (f.read(symbol) == FileIO::Status::Ok) {
+                    ++symbols;
+                  }
+                  return Harness::Work{symbols, corpus.size()};
+                });
+  }
+}
+
+static void benchFileCache(Harness &harness) {
+  const size_t size = harness.corpusSize();
+  IoCounters counters;
+
+  harness.run("file_cache.add_forward", [size, &counters]() {
+    FileCache cache(counters);
+    for (size_t i = 0; i < size; ++i) {
+      cache.addForward(static_cast<char>(i));
+    }
+    return Harness::Work{size, size};
+  });
+
+  FileCache cache(counters);
+  for (size_t i = 0; i < size; ++i) {
+    cache.addForward(static_cast<char>(i));
+  }
+
+  harness.run("file_cache.read_forward", [&cache]() {
+    char byte;
+    size_t bytes = 0;
+    cache.rewindToStart();
+    while (cache.readForward(byte)) {
+      ++bytes;
+    }
+    return Harness::Work{bytes, bytes};
+  });
+
+  harness.run("file_cache.read_backward", [&cache]() {
+    char byte;
+    size_t bytes = 0;
+    cache.rewindToEnd();
+    while (cache.readBackward(byte)) {
+      ++bytes;
+    }
+    return Harness::Work{bytes, bytes};
+  });
+
+  harness.run("file_cache.offset", [&cache]() {
+    static const size_t offsets = 100000;
+    Random random(offsets);
+    cache.rewindToStart();
+    for (size_t i = 0; i < offsets; ++i) {
+      cache.offsetTo(static_cast<int>(random.next(2000)) - 1000);
+    }
+    return Harness::Work{offsets, 0};
+  });
+}
+
+static std::vector<std::pair<int, int>> terminal_sizes{
+    {80, 24}, {200, 60}, {500, 150}};
+
+static std::string sizeName(const std::pair<int, int> &size) {
+  std::ostringstream name;
+  name << size.first << "x" << size.second;
+  return name.str();
+}
+
+static void benchLayout(Harness &harness, const Corpus &corpus) {
+  for (const auto &size : terminal_sizes) {
+    for (auto direction : {Direction::Forward, Direction::Backward}) {
+      const std::string name = (direction == Direction::Forward)
+                                   ? "layout.forward."
+                                   : "layout.backward.";
+
+      harness.run(name + corpus.name() + "." + sizeName(size),
+                  [&corpus, &size, direction]() {
+                    Config config;
+                    config.width = size.first;
+                    config.height = size.second;
+                    Stats stats(config);
+                    HeadlessTerminal terminal(config, stats);
+                    FileReader reader(config, terminal);
+                    FileIO f(corpus.path().c_str(), stats.getIoCounters());
+                    size_t pages = 0;
+
+                    while (true) {
+                      f.newPage(direction);
+                      reader.newPage(direction);
+                      reader.read(f);
+                      if (!reader.linesRead()) {
+                        break;
+                      }
+                      ++pages;
+                    }
+                    return Harness::Work{pages, corpus.size()};
+                  });
+    }
+  }
+}
+
+static std::vector<std::string> animationNames() {
+  std::vector<std::string> names;
+  std::istringstream stream(AnimationStore::getNames());
+  std::string name;
+
+  while (std::getline(stream, name, ',')) {
+    names.push_back(name.substr(name.find_first_not_of(' ')));
+  }
+  return names;
+}
+
+static void benchAnimations(Harness &harness, const Corpus &corpus) {
+  for (const auto &size : terminal_sizes) {
+    for (const auto &name : animationNames()) {
+      Config config;
+      config.delay = 0;
+      config.width = size.first;
+      config.height = size.second;
+      Stats stats(config);
+      HeadlessTerminal terminal(config, stats);
+      FileReader reader(config, terminal);
+      FileIO f(corpus.path().c_str(), stats.getIoCounters());
+      AnimationStore animations(config, terminal, stats);
+      Animation *animation = animations.get(name);
+      animation->onStop(
+          []() { ev::get_default_loop().break_loop(ev::ONE); });
+
+      f.newPage(Direction::Forward);
+      reader.newPage(Direction::Forward);
+      reader.read(f);
+
+      harness.run("tick." + name + "." + sizeName(size),
+                  [&terminal, &reader, animation]() {
+                    const size_t frames = terminal.framesShown();
+
+                    animation->play(reader);
+                    if (animation->isPlaying()) {
+                      ev_run(EV_DEFAULT, 0);
+                    }
+                    return Harness::Work{terminal.framesShown() - frames, 0};
+                  });
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (!setlocale(LC_CTYPE, "C.UTF-8") && !setlocale(LC_CTYPE, "en_US.UTF-8")) {
+    fprintf(stderr, "Can't set UTF-8 locale\n");
+    return 1;
+  }
+
+  try {
+    Harness harness(argc, argv);
+    const size_t size = harness.corpusSize();
+    Corpus ascii(Corpus::Type::Ascii, size);
+    Corpus cjk(Corpus::Type::Cjk, size);
+    Corpus invalid(Corpus::Type::Invalid, size);
+
+    for (const Corpus *corpus : {&ascii, &cjk, &invalid}) {
+      benchFileIO(harness, *corpus);
+    }
+    benchFileCache(harness);
+    for (const Corpus *corpus : {&ascii, &cjk}) {
+      benchLayout(harness, *corpus);
+    }
+    benchAnimations(harness, ascii);
+
+    harness.report(stdout);
+  } catch (std::exception &e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,331 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+// Runs mattext inside a pseudo-terminal, presses keys and measures how fast
+// changes appear in its output.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "corpus.h"
+#include "pty_process.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::string mattext;
+  std::string animation = "matrix";
+  int delay = 20;
+  int width = 120;
+  int height = 40;
+  int runs = 2;
+  int presses = 10;
+  size_t corpus_size = 1 << 20;
+  size_t huge_size = 64 << 20;
+};
+
+static const char *usage =
+    "Usage: mattext_latency [options] path/to/mattext\n"
+    "       mattext_latency --generate type size path\n"
+    "Options:\n"
+    "  --animation name    animation to use, default matrix\n"
+    "  --delay ms          delay between frames, default 20\n"
+    "  --width value       terminal width, default 120\n"
+    "  --height value      terminal height, default 40\n"
+    "  --runs value        mattext starts per corpus, default 2\n"
+    "  --presses value     key presses per start, default 10\n"
+    "  --corpus-size bytes size of regular corpora, default 1M\n"
+    "  --huge-size bytes   size of huge corpus, default 64M\n";
+
+// Counts symbols printed to terminal, skipping escape sequences
+class OutputScanner {
+ public:
+  size_t scan(const std::string &data, size_t start);
+
+ private:
+  enum class State { Text, Escape, Csi, Charset };
+  State state = State::Text;
+};
+
+size_t OutputScanner::scan(const std::string &data, size_t start) {
+  size_t symbols = 0;
+
+  for (size_t i = start; i < data.size(); ++i) {
+    const unsigned char byte = data[i];
+    switch (state) {
+      case State::Text:
+        if (byte == 0x1b) {
+          state = State::Escape;
+        } else if ((byte >= 0x20) && (byte != 0x7f)
+                   && ((byte & 0xc0) != 0x80)) {
+          // UTF-8 continuation bytes are not counted
+          ++symbols;
+        }
+        break;
+      case State::Escape:
+        if (byte == '[') {
+          state = State::Csi;
+        } else if ((byte == '(') || (byte == ')')) {
+          state = State::Charset;
+        } else {
+          state = State::Text;
+        }
+        break;
+      case State::Csi:
+        if ((byte >= 0x40) && (byte <= 0x7e)) {
+          state = State::Text;
+        }
+        break;
+      case State::Charset:
+        state = State::Text;
+        break;
+    }
+  }
+  return symbols;
+}
+
+class Session {
+ public:
+  Session(const Options &options, const Corpus &corpus);
+  // Waits for first printed symbol, returns seconds from since to it
+  double waitSymbols(Clock::time_point since);
+  // Waits until there is no output for a while, returns seconds from since
+  // to the last output
+  double waitQuiet(Clock::time_point since);
+  Clock::time_point press(char key);
+  void quit();
+
+ private:
+  const double timeout = 10.;
+  const double quiet_time;
+  PtyProcess process;
+  OutputScanner scanner;
+  std::string output;
+  Clock::time_point last_output;
+
+  ssize_t read(double timeout);
+};
+
+Session::Session(const Options &options, const Corpus &corpus)
+    : quiet_time(std::max(0.25, options.delay * 5 / 1000.)),
+      process({options.mattext, "-i", "-d", std::to_string(options.delay),
+               "-a", options.animation, corpus.path()},
+              options.width, options.height) {}
+
+ssize_t Session::read(double timeout) {
+  const ssize_t len = process.read(output, timeout);
+  if (len > 0) {
+    last_output = Clock::now();
+  }
+  return len;
+}
+
+double Session::waitSymbols(Clock::time_point since) {
+  while (true) {
+    const size_t start = output.size();
+    const ssize_t len = read(timeout);
+    if (len < 0) {
+      throw std::runtime_error("mattext exited unexpectedly");
+    }
+    if (!len) {
+      throw std::runtime_error("Timed out waiting for mattext output");
+    }
+    if (scanner.scan(output, start)) {
+      return std::chrono::duration<double>(last_output - since).count();
+    }
+  }
+}
+
+double Session::waitQuiet(Clock::time_point since) {
+  while (true) {
+    const size_t start = output.size();
+    const ssize_t len = read(quiet_time);
+    if (len < 0) {
+      throw std::runtime_error("mattext exited unexpectedly");
+    }
+    if (!len) {
+      return std::chrono::duration<double>(last_output - since).count();
+    }
+    scanner.scan(output, start);
+    // Keep memory usage low, only the scanner state matters
+    output.clear();
+  }
+}
+
+Clock::time_point Session::press(char key) {
+  output.clear();
+  process.write(std::string(1, key));
+  return Clock::now();
+}
+
+void Session::quit() {
+  process.write("q");
+  while (read(timeout) > 0) {
+    output.clear();
+  }
+  process.wait();
+}
+
+struct Samples {
+  std::string corpus;
+  std::vector<double> startup;
+  std::vector<double> key_to_symbol;
+  std::vector<double> transition;
+};
+
+static void measure(const Options &options, const Corpus &corpus,
+                    Samples &samples) {
+  for (int run = 0; run < options.runs; ++run) {
+    const auto start = Clock::now();
+    Session session(options, corpus);
+
+    samples.startup.push_back(session.waitSymbols(start));
+    session.waitQuiet(start);
+
+    for (int i = 0; i < options.presses; ++i) {
+      // Mostly go forward, sometimes return back
+      const auto pressed = session.press((i % 4 == 3) ? 'b' : 'f');
+      samples.key_to_symbol.push_back(session.waitSymbols(pressed));
+      samples.transition.push_back(session.waitQuiet(pressed));
+    }
+    session.quit();
+  }
+}
+
+static double percentile(std::vector<double> values, double p) {
+  if (values.empty()) {
+    return 0.;
+  }
+  std::sort(values.begin(), values.end());
+  return values[std::min(values.size() - 1,
+                         static_cast<size_t>(p * values.size()))];
+}
+
+static void printMetric(FILE *out, const char *name,
+                        const std::vector<double> &values, bool last) {
+  fprintf(out,
+          "      \"%s\": {\"samples\": %zu, \"p50_ms\": %.3f, "
+          "\"p90_ms\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f}%s\n",
+          name, values.size(), percentile(values, 0.5) * 1000,
+          percentile(values, 0.9) * 1000, percentile(values, 0.99) * 1000,
+          percentile(values, 1.) * 1000, last ? "" : ",");
+}
+
+static void report(FILE *out, const Options &options,
+                   const std::vector<Samples> &results) {
+  fprintf(out,
+          "{\n  \"animation\": \"%s\", \"delay_ms\": %d, "
+          "\"terminal\": \"%dx%d\",\n  \"corpora\": [",
+          options.animation.c_str(), options.delay, options.width,
+          options.height);
+  for (size_t i = 0; i < results.size(); ++i) {
+    fprintf(out, "%s\n    {\"name\": \"%s\",\n", i ? "," : "",
+            results[i].corpus.c_str());
+    printMetric(out, "startup_to_first_frame", results[i].startup, false);
+    printMetric(out, "key_to_first_changed_cell", results[i].key_to_symbol,
+                false);
+    printMetric(out, "transition", results[i].transition, true);
+    fprintf(out, "    }");
+  }
+  fprintf(out, "\n  ]\n}\n");
+}
+
+static Options parseOptions(int argc, char *argv[]) {
+  Options options;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = (i + 1) < argc;
+
+    if ((arg == "--animation") && has_value) {
+      options.animation = argv[++i];
+    } else if ((arg == "--delay") && has_value) {
+      options.delay = atoi(argv[++i]);
+    } else if ((arg == "--width") && has_value) {
+      options.width = atoi(argv[++i]);
+    } else if ((arg == "--height") && has_value) {
+      options.height = atoi(argv[++i]);
+    } else if ((arg == "--runs") && has_value) {
+      options.runs = atoi(argv[++i]);
+    } else if ((arg == "--presses") && has_value) {
+      options.presses = atoi(argv[++i]);
+    } else if ((arg == "--corpus-size") && has_value) {
+      options.corpus_size = Corpus::parseSize(argv[++i]);
+    } else if ((arg == "--huge-size") && has_value) {
+      options.huge_size = Corpus::parseSize(argv[++i]);
+    } else if ((arg[0] == '-') || !options.mattext.empty()) {
+      throw std::runtime_error(usage);
+    } else {
+      options.mattext = arg;
+    }
+  }
+  if (options.mattext.empty() || (options.width < 1) || (options.height < 1)
+      || (options.runs < 1) || !options.corpus_size || !options.huge_size) {
+    throw std::runtime_error(usage);
+  }
+  return options;
+}
+
+int main(int argc, char *argv[]) {
+  try {
+    if ((argc > 1) && !strcmp(argv[1], "--generate")) {
+      if (argc != 5) {
+        throw std::runtime_error(usage);
+      }
+      Corpus corpus(Corpus::getType(argv[2]), Corpus::parseSize(argv[3]),
+                    argv[4]);
+      return 0;
+    }
+
+    const Options options = parseOptions(argc, argv);
+    std::vector<std::pair<std::string, std::unique_ptr<Corpus>>> corpora;
+    corpora.emplace_back("long_lines",
+                         std::make_unique<Corpus>(Corpus::Type::LongLines,
+                                                  options.corpus_size));
+    corpora.emplace_back("tabs", std::make_unique<Corpus>(
+                                     Corpus::Type::Tabs, options.corpus_size));
+    corpora.emplace_back("cjk", std::make_unique<Corpus>(Corpus::Type::Cjk,
+                                                         options.corpus_size));
+    corpora.emplace_back("huge", std::make_unique<Corpus>(Corpus::Type::Ascii,
+                                                          options.huge_size));
+    std::vector<Samples> results;
+
+    for (const auto &corpus : corpora) {
+      fprintf(stderr, "measuring %s\n", corpus.first.c_str());
+      results.emplace_back();
+      results.back().corpus = corpus.first;
+      measure(options, *corpus.second, results.back());
+    }
+    report(stdout, options, results);
+  } catch (std::exception &e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,340 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+// Feeds synthetic corpus through plain mode with every combination of
+// centering flags and tab widths, compares throughput with stored baseline.
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "corpus.h"
+#include "pty_process.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::string mattext;
+  std::string corpus = "tabs";
+  size_t size = 64 << 20;
+  int width = 120;
+  int height = 40;
+  int runs = 1;
+  std::string baseline;
+  std::string save_baseline;
+  double max_regression = 10.;
+};
+
+static const char *usage =
+    "Usage: mattext_throughput [options] path/to/mattext\n"
+    "Options:\n"
+    "  --corpus type          corpus type, default tabs\n"
+    "  --size bytes           corpus size, default 64M\n"
+    "  --width value          terminal width, default 120\n"
+    "  --height value         terminal height, default 40\n"
+    "  --runs value           runs per combination, best is taken, "
+    "default 1\n"
+    "  --baseline file        compare throughput with baseline, the file\n"
+    "                         is created when it does not exist\n"
+    "  --save-baseline file   save throughput as new baseline\n"
+    "  --max-regression pct   allowed throughput drop, default 10\n"
+    "Exit status is 2 when throughput dropped more than allowed or baseline\n"
+    "has no result for some combination.\n";
+
+// CPU cycles spent by child processes started after construction. Counter is
+// inherited by children and is enabled when they call exec, so setup in
+// parent is not counted.
+class ChildCycles {
+ public:
+  ChildCycles();
+  ~ChildCycles();
+  bool available() const;
+  uint64_t read() const;
+
+ private:
+  int fd = -1;
+};
+
+ChildCycles::ChildCycles() {
+#ifdef __linux__
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_CPU_CYCLES;
+  attr.disabled = 1;
+  attr.inherit = 1;
+  attr.enable_on_exec = 1;
+  attr.exclude_hv = 1;
+
+  fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  if ((fd == -1) && (errno == EACCES)) {
+    // Unprivileged users may be allowed to count user space only
+    attr.exclude_kernel = 1;
+    fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+#endif
+}
+
+ChildCycles::~ChildCycles() {
+  if (fd != -1) {
+    close(fd);
+  }
+}
+
+bool ChildCycles::available() const {
+  return fd != -1;
+}
+
+uint64_t ChildCycles::read() const {
+  uint64_t value = 0;
+
+  if ((fd == -1) || (::read(fd, &value, sizeof(value)) != sizeof(value))) {
+    return 0;
+  }
+  return value;
+}
+
+struct Result {
+  std::string name;
+  double seconds = 0.;
+  double cpu_seconds = 0.;
+  uint64_t cycles = 0;
+  bool has_cycles = false;
+};
+
+static double childrenCpuTime() {
+  struct rusage usage;
+  getrusage(RUSAGE_CHILDREN, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+         + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+static Result runPlain(const Options &options, const Corpus &corpus,
+                       const std::vector<std::string> &flags) {
+  std::vector<std::string> args{options.mattext};
+  args.insert(args.end(), flags.begin(), flags.end());
+  args.push_back(corpus.path());
+
+  ChildCycles cycles;
+  const double cpu_start = childrenCpuTime();
+  const auto start = Clock::now();
+  // Stdin has to be a terminal, stdout is not, so mattext runs plain mode
+  PtyProcess process(args, options.width, options.height, true);
+  std::string output;
+  while (process.read(output, 1.) >= 0) {
+  }
+  const int status = process.wait();
+
+  Result result;
+  result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  result.cpu_seconds = childrenCpuTime() - cpu_start;
+  result.has_cycles = cycles.available();
+  result.cycles = cycles.read();
+
+  if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+    std::ostringstream err;
+    err << "mattext failed: " << output;
+    throw std::runtime_error(err.str());
+  }
+  return result;
+}
+
+static double throughput(const Result &result, size_t size) {
+  return size / result.seconds / (1 << 20);
+}
+
+static std::map<std::string, double> loadBaseline(const std::string &path) {
+  std::map<std::string, double> baseline;
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("Can't open baseline " + path);
+  }
+
+  std::string name;
+  double value;
+  while (file >> name >> value) {
+    baseline[name] = value;
+  }
+  return baseline;
+}
+
+static void saveBaseline(const std::string &path,
+                         const std::vector<Result> &results, size_t size) {
+  std::ofstream file(path);
+  for (const auto &result : results) {
+    file << result.name << " " << throughput(result, size) << "\n";
+  }
+  if (!file) {
+    throw std::runtime_error("Can't write baseline " + path);
+  }
+}
+
+static Options parseOptions(int argc, char *argv[]) {
+  Options options;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = (i + 1) < argc;
+
+    if ((arg == "--corpus") && has_value) {
+      options.corpus = argv[++i];
+    } else if ((arg == "--size") && has_value) {
+      options.size = Corpus::parseSize(argv[++i]);
+    } else if ((arg == "--width") && has_value) {
+      options.width = atoi(argv[++i]);
+    } else if ((arg == "--height") && has_value) {
+      options.height = atoi(argv[++i]);
+    } else if ((arg == "--runs") && has_value) {
+      options.runs = atoi(argv[++i]);
+    } else if ((arg == "--baseline") && has_value) {
+      options.baseline = argv[++i];
+    } else if ((arg == "--save-baseline") && has_value) {
+      options.save_baseline = argv[++i];
+    } else if ((arg == "--max-regression") && has_value) {
+      options.max_regression = atof(argv[++i]);
+    } else if ((arg[0] == '-') || !options.mattext.empty()) {
+      throw std::runtime_error(usage);
+    } else {
+      options.mattext = arg;
+    }
+  }
+  if (options.mattext.empty() || !options.size || (options.width < 1)
+      || (options.height < 1) || (options.runs < 1)) {
+    throw std::runtime_error(usage);
+  }
+  return options;
+}
+
+int main(int argc, char *argv[]) {
+  try {
+    const Options options = parseOptions(argc, argv);
+    Corpus corpus(Corpus::getType(options.corpus), options.size);
+    std::vector<Result> results;
+
+    for (int tab_width : {4, 8}) {
+      // -L implies -C, so they are not combined
+      for (const char *center : {"", "C", "L"}) {
+        std::vector<std::string> flags{"-t", std::to_string(tab_width)};
+        std::string name = "t" + std::to_string(tab_width);
+        if (*center) {
+          flags.push_back(std::string("-") + center);
+          name += std::string("_") + center;
+        }
+
+        fprintf(stderr, "measuring %s\n", name.c_str());
+        Result best;
+        for (int run = 0; run < options.runs; ++run) {
+          Result result = runPlain(options, corpus, flags);
+          if (!run || (result.seconds < best.seconds)) {
+            best = result;
+          }
+        }
+        best.name = name;
+        results.push_back(best);
+      }
+    }
+
+    // First run with a baseline path creates it
+    std::map<std::string, double> baseline;
+    std::string save_baseline = options.save_baseline;
+    const bool compare = !options.baseline.empty()
+                         && (access(options.baseline.c_str(), F_OK) == 0);
+    if (compare) {
+      baseline = loadBaseline(options.baseline);
+    } else if (!options.baseline.empty() && save_baseline.empty()) {
+      save_baseline = options.baseline;
+    }
+    bool regressed = false;
+    std::vector<std::string> missing;
+
+    printf("{\n  \"corpus\": \"%s\", \"bytes\": %zu, \"terminal\": \"%dx%d\",\n"
+           "  \"results\": [",
+           corpus.name().c_str(), corpus.size(), options.width,
+           options.height);
+    for (size_t i = 0; i < results.size(); ++i) {
+      const Result &result = results[i];
+      const double mb_per_s = throughput(result, corpus.size());
+      printf("%s\n    {\"name\": \"%s\", \"mb_per_s\": %.3f, ", i ? "," : "",
+             result.name.c_str(), mb_per_s);
+      if (result.has_cycles) {
+        printf("\"cycles_per_byte\": %.3f, ",
+               static_cast<double>(result.cycles) / corpus.size());
+      } else {
+        printf("\"cycles_per_byte\": null, ");
+      }
+      printf("\"cpu_ns_per_byte\": %.3f",
+             result.cpu_seconds * 1e9 / corpus.size());
+
+      auto base = baseline.find(result.name);
+      if (base != baseline.end()) {
+        const double change = (mb_per_s / base->second - 1.) * 100.;
+        const bool failed = change < -options.max_regression;
+        printf(", \"baseline_mb_per_s\": %.3f, \"change_pct\": %.2f, "
+               "\"regressed\": %s",
+               base->second, change, failed ? "true" : "false");
+        regressed = regressed || failed;
+      } else if (compare) {
+        printf(", \"baseline_mb_per_s\": null");
+        missing.push_back(result.name);
+      }
+      printf("}");
+    }
+    printf("\n  ]\n}\n");
+
+    if (!save_baseline.empty()) {
+      saveBaseline(save_baseline, results, corpus.size());
+      fprintf(stderr, "Saved baseline %s\n", save_baseline.c_str());
+    }
+    for (const auto &name : missing) {
+      fprintf(stderr, "Baseline %s has no result for %s\n",
+              options.baseline.c_str(), name.c_str());
+    }
+    if (regressed) {
+      fprintf(stderr, "Throughput dropped more than %.1f%% against %s\n",
+              options.max_regression, options.baseline.c_str());
+    }
+    if (regressed || !missing.empty()) {
+      return 2;
+    }
+  } catch (std::exception &e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "pty_process.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sstream>
+#include <stdexcept>
+#ifdef __APPLE__
+#include <util.h>
+#else
+#include <pty.h>
+#endif
+
+PtyProcess::PtyProcess(const std::vector<std::string> &args, int width,
+                       int height, bool stdout_null) {
+  struct winsize w_size;
+  memset(&w_size, 0, sizeof(w_size));
+  w_size.ws_col = width;
+  w_size.ws_row = height;
+
+  std::vector<char *> argv;
+  for (const auto &arg : args) {
+    argv.push_back(const_cast<char *>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  pid = forkpty(&fd, nullptr, nullptr, &w_size);
+  if (pid == -1) {
+    std::ostringstream err;
+    err << "Can't create pseudo-terminal: " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+  if (!pid) {
+    if (stdout_null) {
+      int null_fd = open("/dev/null", O_WRONLY);
+      if ((null_fd == -1) || (dup2(null_fd, STDOUT_FILENO) == -1)) {
+        _exit(127);
+      }
+    }
+    execv(argv[0], argv.data());
+    _exit(127);
+  }
+}
+
+PtyProcess::~PtyProcess() {
+  if (pid > 0) {
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+  }
+  if (fd != -1) {
+    close(fd);
+  }
+}
+
+void PtyProcess::write(const std::string &data) {
+  if (::write(fd, data.data(), data.size())
+      != static_cast<ssize_t>(data.size())) {
+    std::ostringstream err;
+    err << "Can't write to pseudo-terminal: " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+}
+
+ssize_t PtyProcess::read(std::string &data, double timeout) {
+  struct pollfd poll_fd = {fd, POLLIN, 0};
+  int ret = poll(&poll_fd, 1, static_cast<int>(timeout * 1000));
+
+  if (ret == -1) {
+    if (errno == EINTR) {
+      return 0;
+    }
+    std::ostringstream err;
+    err << "Can't poll pseudo-terminal: " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+  if (!ret) {
+    return 0;
+  }
+
+  char buf[65536];
+  ssize_t len = ::read(fd, buf, sizeof(buf));
+  // Linux returns EIO when slave side is closed
+  if (len <= 0) {
+    return -1;
+  }
+  data.append(buf, len);
+  return len;
+}
+
+int PtyProcess::wait() {
+  int status = 0;
+
+  if (pid > 0) {
+    waitpid(pid, &status, 0);
+    pid = -1;
+  }
+  return status;
+}
+
+pid_t PtyProcess::getPid() const {
+  return pid;
+}
@@ -0,0 +1,47 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <sys/types.h>
+#include <string>
+#include <vector>
+
+// Child process running inside a pseudo-terminal
+class PtyProcess {
+ public:
+  // Stdout of child is redirected to /dev/null if stdout_null is set, stdin
+  // is still a pseudo-terminal then
+  PtyProcess(const std::vector<std::string> &args, int width, int height,
+             bool stdout_null = false);
+  ~PtyProcess();
+  void write(const std::string &data);
+  // Waits for output at most timeout seconds, appends it to data. Returns
+  // number of bytes read, 0 on timeout and -1 when child closed terminal.
+  ssize_t read(std::string &data, double timeout);
+  // Returns exit status
+  int wait();
+  pid_t getPid() const;
+
+ private:
+  pid_t pid = -1;
+  int fd = -1;
+};
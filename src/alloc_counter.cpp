@@ -0,0 +1,103 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "alloc_counter.h"
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#ifdef MATTEXT_COUNT_ALLOCS
+
+static std::atomic<uint64_t> allocs_num{0};
+
+void *operator new(size_t size) {
+  ++allocs_num;
+  void *ptr = malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void *operator new[](size_t size) {
+  return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t & /*unused*/) noexcept {
+  ++allocs_num;
+  return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept {
+  return operator new(size, tag);
+}
+
+void operator delete(void *ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void *ptr, size_t /*size*/) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void *ptr, size_t /*size*/) noexcept {
+  free(ptr);
+}
+
+bool AllocCounter::isEnabled() {
+  return true;
+}
+
+uint64_t AllocCounter::count() {
+  return allocs_num.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool AllocCounter::isEnabled() {
+  return false;
+}
+
+uint64_t AllocCounter::count() {
+  return 0;
+}
+
+#endif
+
+void AllocTotals::add(uint64_t run_allocs) {
+  ++calls;
+  allocs += run_allocs;
+  max = std::max(max, run_allocs);
+}
+
+AllocScope::AllocScope(AllocTotals *totals)
+    : totals(totals), start(totals ? AllocCounter::count() : 0) {}
+
+AllocScope::~AllocScope() {
+  if (totals) {
+    totals->add(AllocCounter::count() - start);
+  }
+}
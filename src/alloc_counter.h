@@ -0,0 +1,53 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+// Counts operator new calls in all threads when mattext is built with
+// MATTEXT_COUNT_ALLOCS cmake option
+class AllocCounter {
+ public:
+  static bool isEnabled();
+  static uint64_t count();
+};
+
+// Allocations accumulated over all runs of a scope
+struct AllocTotals {
+  uint64_t calls = 0;
+  uint64_t allocs = 0;
+  uint64_t max = 0;
+
+  void add(uint64_t run_allocs);
+};
+
+// Adds allocations from construction to destruction to totals, does nothing
+// if totals are nullptr
+class AllocScope {
+ public:
+  AllocScope(AllocTotals *totals);
+  ~AllocScope();
+
+ private:
+  AllocTotals *totals;
+  uint64_t start;
+};
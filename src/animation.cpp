@@ -30,34 +30,42 @@ Mattext is distributed in the hope that it will be useful,
 
 struct AnimationInfo {
   std::string name;
-  std::function<std::unique_ptr<Animation>(const Config &, const Terminal &)>
+  std::function<std::unique_ptr<Animation>(const Config &, const Terminal &,
+                                           Stats &, const std::string &)>
       make;
 };
 
 static std::list<AnimationInfo> animation_info{
     {"matrix",
-     [](const Config &config, const Terminal &terminal) {
-       return std::make_unique<MatrixAnimation>(config, terminal);
+     [](const Config &config, const Terminal &terminal, Stats &stats,
+        const std::string &name) {
+       return std::make_unique<MatrixAnimation>(config, terminal, stats, name);
      }},
     {"reverse_matrix",
-     [](const Config &config, const Terminal &terminal) {
-       return std::make_unique<ReverseMatrixAnimation>(config, terminal);
+     [](const Config &config, const Terminal &terminal, Stats &stats,
+        const std::string &name) {
+       return std::make_unique<ReverseMatrixAnimation>(config, terminal, stats,
+                                                       name);
      }},
     {"none",
-     [](const Config & /*unused*/, const Terminal &terminal) {
+     [](const Config & /*unused*/, const Terminal &terminal,
+        Stats & /*unused*/, const std::string & /*unused*/) {
        return std::make_unique<NoneAnimation>(terminal);
      }},
     {"fire",
-     [](const Config &config, const Terminal &terminal) {
-       return std::make_unique<FireAnimation>(config, terminal);
+     [](const Config &config, const Terminal &terminal, Stats &stats,
+        const std::string &name) {
+       return std::make_unique<FireAnimation>(config, terminal, stats, name);
      }},
-    {"beam", [](const Config &config, const Terminal &terminal) {
-       return std::make_unique<BeamAnimation>(config, terminal);
+    {"beam", [](const Config &config, const Terminal &terminal, Stats &stats,
+                const std::string &name) {
+       return std::make_unique<BeamAnimation>(config, terminal, stats, name);
      }}};
 
-AnimationStore::AnimationStore(const Config &config, const Terminal &terminal) {
+AnimationStore::AnimationStore(const Config &config, const Terminal &terminal,
+                               Stats &stats) {
   for (auto &info : animation_info) {
-    animations[info.name] = info.make(config, terminal);
+    animations[info.name] = info.make(config, terminal, stats, info.name);
   }
 }
 
@@ -31,18 +31,22 @@ Mattext is distributed in the hope that it will be useful,
 class Text;
 class Config;
 class Terminal;
+class Stats;
 
 class Animation {
  public:
   virtual ~Animation() = default;
-  virtual void play(const Text &text, std::function<void()> on_stop) = 0;
+  // Callback is called when animation stops, it is set once instead of
+  // copying it on every page
+  virtual void onStop(std::function<void()> on_stop) = 0;
+  virtual void play(const Text &text) = 0;
   virtual void stop() = 0;
   virtual bool isPlaying() = 0;
 };
 
 class AnimationStore {
  public:
-  AnimationStore(const Config &config, const Terminal &terminal);
+  AnimationStore(const Config &config, const Terminal &terminal, Stats &stats);
   Animation *get(std::string) const;
   static std::string getNames();
 
@@ -20,7 +20,7 @@ Mattext is distributed in the hope that it will be useful,
 *******************************************************************************/
 
 #include "animation_beam.h"
-#include <math.h>
+#include <algorithm>
 #include "config.h"
 #include "file_reader.h"
 #include "terminal.h"
@@ -37,44 +37,48 @@ void BeamAnimation::init() {
   beam_height = 0;
   beam_step = 0;
   text_edges.resize(terminal_height);
+  screen = {0, 0, terminal_width, terminal_height};
+  // Flash grows by 2 on each of first flash_max_radius / 2 + 1 ticks, outer
+  // circle is one wider
+  circles.reserve(flash_max_radius + 4);
 
   for (auto &edge : text_edges) {
     edge = std::make_pair(-1, -1);
   }
 
-  text_show_cb = [this](int x, int y) {
-    if (y == terminal_height - 1) {
-      return L' ';
-    }
-    if (x >= (terminal_width / 2)) {
-      int edge = text_edges[y].second;
-      if (edge == -1) {
-        edge = terminal_width / 2;
-      }
-      for (int i = edge; i < x; ++i) {
-        terminal.set(i, y, text->get(i, y), false, ColorBlack, ColorWhite);
-      }
-      text_edges[y].second = x;
-    } else {
-      int edge = text_edges[y].first;
-      if (edge == -1) {
-        edge = terminal_width / 2 - 1;
-      }
-      for (int i = x + 1; i <= edge; ++i) {
-        terminal.set(i, y, text->get(i, y), false, ColorBlack, ColorWhite);
-      }
-      text_edges[y].first = x;
-    }
+  terminal.setColors(ColorBlack, ColorBlack);
+  terminal.fillRect(0, 0, terminal_width, terminal_height, L'#', false,
+                    ColorBlack, ColorBlack);
+}
 
-    return L'|';
-  };
+// Shows columns [begin, end) of text in row y
+void BeamAnimation::showTextRange(int y, int begin, int end) {
+  terminal.blitText(*grid, begin, y, end - begin, 1, false, ColorBlack,
+                    ColorWhite);
+}
 
-  terminal.setColors(ColorBlack, ColorBlack);
-  for (int x = 0; x < terminal_width; ++x) {
-    for (int y = 0; y < terminal_height; ++y) {
-      terminal.set(x, y, '#', false, ColorBlack, ColorBlack);
+// Shows text between beam point and previous position of the beam in row y
+wchar_t BeamAnimation::showTextTo(int x, int y) {
+  if (y == terminal_height - 1) {
+    return L' ';
+  }
+  if (x >= (terminal_width / 2)) {
+    int edge = text_edges[y].second;
+    if (edge == -1) {
+      edge = terminal_width / 2;
+    }
+    showTextRange(y, edge, x);
+    text_edges[y].second = x;
+  } else {
+    int edge = text_edges[y].first;
+    if (edge == -1) {
+      edge = terminal_width / 2 - 1;
     }
+    showTextRange(y, x + 1, edge + 1);
+    text_edges[y].first = x;
   }
+
+  return L'|';
 }
 
 void BeamAnimation::showText() {
@@ -98,12 +102,8 @@ void BeamAnimation::showText() {
       beam_1_y = terminal_height / 2;
       beam_2_y = terminal_height / 2;
       for (int y = 0; y < terminal_height / 2; ++y) {
-        for (int i = 0; i <= text_edges[y].first; ++i) {
-          terminal.set(i, y, text->get(i, y), false, ColorBlack, ColorWhite);
-        }
-        for (int i = text_edges[y].second; i <= terminal_width - 1; ++i) {
-          terminal.set(i, y, text->get(i, y), false, ColorBlack, ColorWhite);
-        }
+        showTextRange(y, 0, text_edges[y].first + 1);
+        showTextRange(y, text_edges[y].second, terminal_width);
       }
       break;
     case 3:
@@ -111,44 +111,46 @@ void BeamAnimation::showText() {
       beam_1_y = center_y;
       beam_2_y = center_y;
       for (int y = terminal_height / 2; y < center_y; ++y) {
-        for (int i = 0; i <= text_edges[y].first; ++i) {
-          terminal.set(i, y, text->get(i, y), false, ColorBlack, ColorWhite);
-        }
-        for (int i = text_edges[y].second; i < terminal_width; ++i) {
-          terminal.set(i, y, text->get(i, y), false, ColorBlack, ColorWhite);
-        }
+        showTextRange(y, 0, text_edges[y].first + 1);
+        showTextRange(y, text_edges[y].second, terminal_width);
       }
       break;
     default:
-      for (int i = 0; i < terminal_width; ++i) {
-        terminal.set(i, center_y, text->get(i, center_y), false, ColorBlack,
-                     ColorWhite);
-      }
+      showTextRange(center_y, 0, terminal_width);
       showing_text = false;
       break;
   }
   if (beam_step < 4) {
-    drawLine(center_x, center_y, beam_1_x, beam_1_y, ColorCyan, text_show_cb);
-    drawLine(center_x - 1, center_y, beam_2_x, beam_2_y, ColorCyan,
-             text_show_cb);
+    auto show_text = [this](int x, int y) {
+      terminal.set(x, y, showTextTo(x, y), false, ColorCyan, ColorCyan);
+    };
+    raster::line(screen, center_x, center_y, beam_1_x, beam_1_y, show_text);
+    raster::line(screen, center_x - 1, center_y, beam_2_x, beam_2_y,
+                 show_text);
     ++beam_step;
   }
 }
 
-void BeamAnimation::showFlash() {
-  const int center_x = terminal_width / 2;
-  const int center_y = terminal_height - 1;
+// Draws circle around bottom center of screen
+void BeamAnimation::drawCircle(int radius, bool bold, int color,
+                               wchar_t symbol) {
+  raster::circle(screen, circles, radius, terminal_width / 2,
+                 terminal_height - 1, bold,
+                 [&](int x, int y, int width, int height) {
+                   terminal.fillRect(x, y, width, height, symbol, false, color,
+                                     color);
+                 });
+}
 
-  drawCircle(flash_radius, center_x, center_y, true, flash_color, flash_symbol);
-  drawCircle(flash_radius + 1, center_x, center_y, true, flash_color,
-             flash_symbol);
+void BeamAnimation::showFlash() {
+  drawCircle(flash_radius, true, flash_color, flash_symbol);
+  drawCircle(flash_radius + 1, true, flash_color, flash_symbol);
 
   if (flash_color != ColorBlack) {
-    drawCircle(flash_radius + 1, center_x, center_y, false, ColorCyan, L'o');
-    drawCircle(flash_radius - 1, center_x, center_y, false, flash_color,
-               flash_symbol);
+    drawCircle(flash_radius + 1, false, ColorCyan, L'o');
+    drawCircle(flash_radius - 1, false, flash_color, flash_symbol);
   } else if (flash_radius > 0) {
-    drawCircle(flash_radius - 1, center_x, center_y, false, ColorCyan);
+    drawCircle(flash_radius - 1, false, ColorCyan);
   }
 
   if ((tick_id <= (flash_max_radius / 2))) {
@@ -171,10 +173,14 @@ void BeamAnimation::showBeam() {
 
   beam_height += (terminal_height / flash_max_radius) + 1;
 
-  drawLine(center_x, center_y - flash_radius - 1, center_x,
-           center_y - beam_height, ColorCyan, [](int, int) { return L'|'; });
-  drawLine(center_x - 1, center_y - flash_radius - 1, center_x - 1,
-           center_y - beam_height, ColorCyan, [](int, int) { return L'|'; });
+  // Beam is two columns from the flash to its top, it is drawn downwards
+  // while it is shorter than the flash
+  const int beam_start = center_y - flash_radius - 1;
+  const int beam_end = center_y - beam_height;
+  const int top = std::min(beam_start, beam_end);
+  terminal.fillRect(center_x - 1, top, 2,
+                    std::max(beam_start, beam_end) - top + 1, L'|', false,
+                    ColorCyan, ColorCyan);
 
   if (beam_height >= terminal_height) {
     showing_beam = false;
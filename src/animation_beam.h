@@ -23,6 +23,7 @@ Mattext is distributed in the hope that it will be useful,
 
 #include <vector>
 #include "animation_generic.h"
+#include "raster.h"
 
 class BeamAnimation : public GenericAnimation {
  public:
@@ -35,16 +36,20 @@ class BeamAnimation : public GenericAnimation {
   bool showing_text;
   int flash_max_radius;
   int flash_radius;
-  short flash_color;
+  int flash_color;
   wchar_t flash_symbol;
   int beam_height;
   int beam_step;
   std::vector<std::pair<int, int>> text_edges;
-  std::function<wchar_t(int, int)> text_show_cb;
+  raster::Rect screen;
+  raster::CircleTable circles;
 
   void init() override;
   virtual void tick(ev::timer &w, int revents) override;
+  void showTextRange(int y, int begin, int end);
+  wchar_t showTextTo(int x, int y);
   void showText();
+  void drawCircle(int radius, bool bold, int color, wchar_t symbol = L' ');
   void showFlash();
   void showBeam();
 };
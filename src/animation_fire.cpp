@@ -20,7 +20,6 @@ Mattext is distributed in the hope that it will be useful,
 *******************************************************************************/
 
 #include "animation_fire.h"
-#include <stdlib.h>
 #include "config.h"
 #include "file_reader.h"
 #include "terminal.h"
@@ -29,14 +28,14 @@ void FireAnimation::init() {
   fire_heights.resize(terminal_width);
   fire_end_heights.resize(terminal_width);
   max_fire_height = terminal_height / 4;
-  size_t prev = 1 + rand() % max_fire_height;
+  size_t prev = 1 + random.next(max_fire_height);
 
   for (auto &height : fire_heights) {
     height = prev;
     if (height == max_fire_height) {
       --height;
     } else {
-      int seed = rand() % 100;
+      int seed = random.next(100);
       if (seed <= 45) {
         ++height;
       } else if ((seed >= 55) && (height > 1)) {
@@ -47,14 +46,14 @@ void FireAnimation::init() {
   }
 
   max_fire_end_height = terminal_height / 8;
-  prev = rand() % max_fire_end_height;
+  prev = random.next(max_fire_end_height);
 
   for (auto &height : fire_end_heights) {
     height = prev;
     if (height == max_fire_end_height) {
       --height;
     } else {
-      int seed = rand() % 100;
+      int seed = random.next(100);
       if (seed <= 45) {
         ++height;
       } else if ((seed >= 55) && (height > 1)) {
@@ -64,6 +63,9 @@ void FireAnimation::init() {
     prev = height;
   }
 
+  increased_cols.assign(terminal_width, false);
+  decreased_ends.assign(terminal_width, false);
+  rand_values.resize(terminal_width * 2);
   tick_id = 0;
 }
 
@@ -73,6 +75,8 @@ void FireAnimation::tick(ev::timer & /*w*/, int /*revents*/) {
   size_t prev = fire_heights[0];
   size_t prev_end = fire_end_heights[0];
 
+  random.fill(rand_values.data(), rand_values.size());
+
   for (int col = 0; col < terminal_width; ++col) {
     auto &height = fire_heights[col];
     int fire_start = terminal_height - 1 - tick_id - height + max_fire_height;
@@ -97,9 +101,8 @@ void FireAnimation::tick(ev::timer & /*w*/, int /*revents*/) {
       terminal.set(col, fire_start + 2, '#', false, ColorRed, ColorYellow);
     }
 
-    auto increased = increased_cols.find(col);
-    if (increased != increased_cols.end()) {
-      increased_cols.erase(increased);
+    if (increased_cols[col]) {
+      increased_cols[col] = false;
 
       if (((fire_start + 1) >= 0) && ((fire_start + 1) < _terminal_height)) {
         terminal.set(col, fire_start + 1, '|', false, ColorYellow, ColorRed);
@@ -115,31 +118,30 @@ void FireAnimation::tick(ev::timer & /*w*/, int /*revents*/) {
     }
 
     if ((fire_end >= 0) && (fire_end < _terminal_height)) {
-      terminal.set(col, fire_end, text->get(col, fire_end), false, ColorDefault,
+      terminal.set(col, fire_end, grid->get(col, fire_end), false, ColorDefault,
                    ColorDefault);
     }
 
-    auto decreased = decreased_ends.find(col);
-    if (decreased != decreased_ends.end()) {
-      decreased_ends.erase(decreased);
+    if (decreased_ends[col]) {
+      decreased_ends[col] = false;
       if (((fire_end + 1) >= 0) && ((fire_end + 1) < _terminal_height)) {
-        terminal.set(col, fire_end + 1, text->get(col, fire_end + 1), false,
+        terminal.set(col, fire_end + 1, grid->get(col, fire_end + 1), false,
                      ColorDefault, ColorDefault);
       }
     }
 
-    int seed = rand() % 100;
+    int seed = rand_values[col * 2] % 100;
     if ((height <= prev) && (((prev - height) > 1)
                              || ((seed <= 55) && (height < max_fire_height)))) {
       ++height;
-      increased_cols.insert(col);
+      increased_cols[col] = true;
     } else if ((height >= prev)
                && (((height - prev) > 1) || ((seed >= 45) && (height > 1)))) {
       --height;
     }
     prev = height;
 
-    seed = rand() % 100;
+    seed = rand_values[col * 2 + 1] % 100;
     if ((end_height <= prev_end)
         && (((prev_end - end_height) > 1)
             || ((seed <= 15) && (end_height < max_fire_end_height)))) {
@@ -148,7 +150,7 @@ void FireAnimation::tick(ev::timer & /*w*/, int /*revents*/) {
                && (((end_height - prev_end) > 1)
                    || ((seed >= 85) && (end_height > 1)))) {
       --end_height;
-      decreased_ends.insert(col);
+      decreased_ends[col] = true;
     }
     prev_end = end_height;
   }
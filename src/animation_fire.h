@@ -21,7 +21,6 @@ Mattext is distributed in the hope that it will be useful,
 
 #pragma once
 
-#include <unordered_set>
 #include <vector>
 #include "animation_generic.h"
 
@@ -35,8 +34,11 @@ class FireAnimation : public GenericAnimation {
   std::vector<size_t> fire_end_heights;
   size_t max_fire_height;
   size_t max_fire_end_height;
-  std::unordered_set<size_t> increased_cols;
-  std::unordered_set<size_t> decreased_ends;
+  // Flags of columns changed on previous tick, not sets, so ticks do not
+  // allocate memory
+  std::vector<char> increased_cols;
+  std::vector<char> decreased_ends;
+  std::vector<uint32_t> rand_values;
 
   void init() override;
   virtual void tick(ev::timer &w, int revents) override;
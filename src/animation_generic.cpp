@@ -20,25 +20,47 @@ Mattext is distributed in the hope that it will be useful,
 *******************************************************************************/
 
 #include "animation_generic.h"
-#include <math.h>
-#include <stdlib.h>
+#include "alloc_counter.h"
 #include "config.h"
+#include "file_reader.h"
+#include "hud.h"
+#include "perf_counters.h"
+#include "stats.h"
 #include "terminal.h"
+#include "trace.h"
 
 GenericAnimation::GenericAnimation(const Config &config,
-                                   const Terminal &terminal)
-    : config(config), terminal(terminal) {}
+                                   const Terminal &terminal, Stats &stats,
+                                   const std::string &name)
+    : config(config),
+      terminal(terminal),
+      random(config.seed),
+      tick_time(stats.getHistogram("tick." + name,
+                                   static_cast<uint64_t>(config.delay)
+                                       * 1000000)),
+      tick_perf(stats.getPerfTotals("tick." + name)),
+      tick_allocs(stats.getAllocTotals("tick." + name)),
+      trace(stats.getTrace()),
+      hud(stats.getHud()),
+      tick_name("tick." + name) {}
+
+void GenericAnimation::onStop(std::function<void()> _on_stop) {
+  on_stop = _on_stop;
+}
 
-void GenericAnimation::play(const Text &_text, std::function<void()> _on_stop) {
+void GenericAnimation::play(const Text &_text) {
   text = &_text;
-  on_stop = _on_stop;
+  grid = &text->getGrid();
   terminal_width = terminal.getWidth();
   terminal_height = terminal.getHeight();
 
   init();
   is_playing = true;
-  timer_watcher.set<GenericAnimation, &GenericAnimation::tick>(this);
-  timer_watcher.start(0., static_cast<double>(config.delay) / 1000.0);
+  timer_watcher.set<GenericAnimation, &GenericAnimation::onTimer>(this);
+  // Zero repeat would make timer fire only once
+  const double repeat =
+      (config.delay > 0) ? static_cast<double>(config.delay) / 1000.0 : 1e-9;
+  timer_watcher.start(0., repeat);
 }
 
 void GenericAnimation::stop() {
@@ -53,83 +75,23 @@ bool GenericAnimation::isPlaying() {
   return is_playing;
 }
 
-void GenericAnimation::drawCircle(int radius, int center_x, int center_y,
-                                  bool bold, short color, wchar_t symbol) {
-  for (int quad = 0; quad < 4; ++quad) {
-    int x_mul = -1;
-    if (quad % 2) {
-      x_mul = 1;
-    }
-    int y_mul = -1;
-    if (quad >= 2) {
-      y_mul = 1;
-    }
-    int prev_h = 0;
-    for (int i = 0; i <= radius; ++i) {
-      const int x = center_x + (i * 2 * x_mul);
-      const int h = sqrt(radius * radius - i * i);
-      const int y = center_y + (h * y_mul) + ((quad >= 2) ? 1 : 0);
-
-      terminal.set(x - 1 + x_mul, y, symbol, false, color, color);
-      terminal.set(x + x_mul, y, symbol, false, color, color);
-      if (prev_h) {
-        if ((prev_h - h) > 1) {
-          for (int k = 1; k <= (prev_h - h); ++k) {
-            terminal.set(x - 1 - x_mul, y + (k * y_mul), symbol, false, color,
-                         color);
-            terminal.set(x - x_mul, y + (k * y_mul), symbol, false, color,
-                         color);
-          }
-        }
-        if (bold && ((prev_h - h) >= 1)) {
-          terminal.set(x - 1 - x_mul, y, symbol, false, color, color);
-          terminal.set(x - x_mul, y, symbol, false, color, color);
-        }
-      }
-      prev_h = h;
-    }
+void GenericAnimation::onTimer(ev::timer &w, int revents) {
+  const bool timed = tick_time || hud.isVisible();
+  const uint64_t start = timed ? Stats::now() : 0;
+  {
+    TraceEvent event(trace, tick_name.c_str());
+    PerfScope perf(tick_perf);
+    AllocScope allocs(tick_allocs);
+    grid = &text->getGrid();
+    tick(w, revents);
   }
-}
-
-// Algorithm taken from
-// http://www.roguebasin.com/index.php?title=Bresenham%27s_Line_Algorithm
-void GenericAnimation::drawLine(int x1, int y1, int x2, int y2, short color,
-                                std::function<wchar_t(int, int)> callback) {
-  int x_delta = x2 - x1;
-  int y_delta = y2 - y1;
-  int x_inc = (x_delta > 0) ? 1 : ((x_delta < 0) ? -1 : 0);
-  int y_inc = (y_delta > 0) ? 1 : ((y_delta < 0) ? -1 : 0);
-  x_delta = abs(x_delta * 2);
-  y_delta = abs(y_delta * 2);
-  if (!callback) {
-    callback = [](int, int) { return L' '; };
+  if (!timed) {
+    return;
   }
 
-  terminal.set(x1, y1, callback(x1, y1), false, color, color);
-
-  if (x_delta >= y_delta) {
-    int error = y_delta - (x_delta / 2);
-
-    while (x1 != x2) {
-      if ((error >= 0) && (error || (x_inc > 0))) {
-        error -= x_delta;
-        y1 += y_inc;
-      }
-      error += y_delta;
-      x1 += x_inc;
-      terminal.set(x1, y1, callback(x1, y1), false, color, color);
-    }
-  } else {
-    int error = x_delta - (y_delta / 2);
-
-    while (y1 != y2) {
-      if ((error >= 0) && (error || (y_inc > 0))) {
-        error -= y_delta;
-        x1 += x_inc;
-      }
-      error += x_delta;
-      y1 += y_inc;
-      terminal.set(x1, y1, callback(x1, y1), false, color, color);
-    }
+  const uint64_t duration = Stats::now() - start;
+  if (tick_time) {
+    tick_time->record(duration);
   }
+  hud.tickDone(duration);
 }
@@ -22,12 +22,24 @@ Mattext is distributed in the hope that it will be useful,
 #pragma once
 
 #include <functional>
+#include <string>
 #include "animation.h"
+#include "random.h"
+#include "terminal.h"
+#include "text_grid.h"
+
+class Histogram;
+class Hud;
+struct AllocTotals;
+struct PerfTotals;
+class Trace;
 
 class GenericAnimation : public Animation {
  public:
-  GenericAnimation(const Config &config, const Terminal &terminal);
-  void play(const Text &text, std::function<void()> on_stop) override;
+  GenericAnimation(const Config &config, const Terminal &terminal,
+                   Stats &stats, const std::string &name);
+  void onStop(std::function<void()> on_stop) override;
+  void play(const Text &text) override;
   void stop() override;
   bool isPlaying() override;
 
@@ -35,17 +47,23 @@ class GenericAnimation : public Animation {
   const Config &config;
   const Terminal &terminal;
   const Text *text;
+  // Screen of text, it is taken again on every tick
+  const TextGrid *grid = nullptr;
   ev::timer timer_watcher;
   bool is_playing = false;
   int terminal_width;
   int terminal_height;
   std::function<void()> on_stop;
+  Random random;
+  Histogram *tick_time;
+  PerfTotals *tick_perf;
+  AllocTotals *tick_allocs;
+  Trace *trace;
+  Hud &hud;
+  const std::string tick_name;
 
   virtual void init() = 0;
   virtual void tick(ev::timer &w, int revents) = 0;
 
-  void drawCircle(int radius, int center_x, int center_y, bool bold,
-                  short color, wchar_t symbol = L' ');
-  void drawLine(int x1, int y1, int x2, int y2, short color,
-                std::function<wchar_t(int, int)> callback = nullptr);
+  void onTimer(ev::timer &w, int revents);
 };
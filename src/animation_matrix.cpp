@@ -20,14 +20,29 @@ Mattext is distributed in the hope that it will be useful,
 *******************************************************************************/
 
 #include "animation_matrix.h"
-#include <stdlib.h>
 #include "config.h"
 #include "file_reader.h"
 #include "terminal.h"
+#include "worker_pool.h"
+
+// Narrower terminals are updated faster than threads are woken up
+static const int parallel_min_width = 512;
+
+MatrixAnimation::MatrixAnimation(const Config &config,
+                                 const Terminal &terminal, Stats &stats,
+                                 const std::string &name)
+    : GenericAnimation(config, terminal, stats, name) {}
+
+MatrixAnimation::~MatrixAnimation() = default;
 
 void MatrixAnimation::init() {
   col_lengths.resize(terminal_width);
   col_offsets.resize(terminal_width);
+  col_heads.resize(terminal_width);
+  cells.resize(terminal_width * col_max_cells);
+  col_cells_num.resize(terminal_width);
+  col_active.resize(terminal_width);
+  rand_values.resize(terminal_width * col_rand_values);
   tick_id = 0;
 
   if (config.rand_columns_len <= 0) {
@@ -38,59 +53,41 @@ void MatrixAnimation::init() {
 
   // Random symbols are organized into columns
   for (int i = 0; i < terminal_width; ++i) {
-    col_lengths[i] = 1 + rand() % max_col_length;
-    col_offsets[i] = rand() % max_col_length;
+    col_lengths[i] = 1 + random.next(max_col_length);
+    col_offsets[i] = random.next(max_col_length);
+  }
+  col_offsets[random.next(terminal_width)] = 0;
+
+  if ((terminal_width >= parallel_min_width) && !workers) {
+    workers = std::make_unique<WorkerPool>();
   }
-  col_offsets[rand() % terminal_width] = 0;
   terminal.setColors(ColorGreen, ColorBlack);
 }
 
-void MatrixAnimation::tick(ev::timer& /*w*/, int /*revents*/) {
-  int _terminal_height = static_cast<int>(terminal_height);
+void MatrixAnimation::tick(ev::timer & /*w*/, int /*revents*/) {
   bool stopped = true;
 
-  for (int col = 0; col < terminal_width; ++col) {
-    int col_start = tick_id - col_offsets[col];
-    int col_end = col_start - col_lengths[col];
-    int text_start = col_end - tail_length - 1;
+  random.fill(rand_values.data(), rand_values.size());
+
+  if (workers && (terminal_width >= parallel_min_width)) {
+    workers->run(terminal_width, [this](size_t begin, size_t end) {
+      this->updateColumns(begin, end);
+    });
+  } else {
+    updateColumns(0, terminal_width);
+  }
 
-    if ((col_start < 0) || (text_start >= _terminal_height)) {
+  // ncurses is not thread-safe, so changes are composed in one thread
+  for (int col = 0; col < terminal_width; ++col) {
+    if (!col_active[col]) {
       continue;
     }
-
     stopped = false;
 
-    // Make previous bottom symbol not bold
-    if ((col_start >= 1) && (col_start <= _terminal_height)) {
-      bool bold = (rand() % 100) > 90;
-      terminal.set(col, col_start - 1, terminal.get(col, col_start - 1), bold,
-                   ColorGreen, ColorBlack);
-    }
-
-    // Place new random symbol to bottom of column
-    if (col_start < _terminal_height) {
-      terminal.set(col, col_start, getRandSymbol(), true, ColorGreen,
-                   ColorBlack);
-    }
-
-    // Change random symbol in column
-    int row_id = rand() % _terminal_height;
-    if ((row_id >= col_end) && (row_id < col_start)) {
-      bool bold = (rand() % 100) > 60;
-      terminal.set(col, row_id, getRandSymbol(), bold, ColorGreen, ColorBlack);
-    }
-
-    // Start showing some of real symbols in column
-    int fade_row_id = (col_end - 1) - rand() % tail_length;
-    if ((fade_row_id >= 0) && (fade_row_id < _terminal_height)) {
-      terminal.set(col, fade_row_id, text->get(col, fade_row_id), false,
-                   ColorGreen, ColorBlack);
-    }
-
-    // Show real text symbol
-    if ((text_start >= 0) && (text_start < _terminal_height)) {
-      terminal.set(col, text_start, text->get(col, text_start), false,
-                   ColorGreen, ColorBlack);
+    const Cell *col_cells = &cells[col * col_max_cells];
+    for (size_t i = 0; i < col_cells_num[col]; ++i) {
+      terminal.set(col, col_cells[i].row, col_cells[i].symbol,
+                   col_cells[i].bold, ColorGreen, ColorBlack);
     }
   }
   ++tick_id;
@@ -101,17 +98,71 @@ void MatrixAnimation::tick(ev::timer& /*w*/, int /*revents*/) {
   }
 }
 
-wchar_t MatrixAnimation::getRandSymbol() {
-  int type = rand() % (config.without_japanese ? 600 : 1000);
+void MatrixAnimation::updateColumns(size_t begin, size_t end) {
+  for (size_t col = begin; col < end; ++col) {
+    col_cells_num[col] = 0;
+    col_active[col] =
+        updateColumn(col, &rand_values[col * col_rand_values],
+                     &cells[col * col_max_cells], col_cells_num[col]);
+  }
+}
+
+bool MatrixAnimation::updateColumn(int col, const uint32_t *rand_values,
+                                   Cell *cells, size_t &cells_num) {
+  const int _terminal_height = static_cast<int>(terminal_height);
+  int col_start = tick_id - col_offsets[col];
+  int col_end = col_start - col_lengths[col];
+  int text_start = col_end - tail_length - 1;
+
+  if ((col_start < 0) || (text_start >= _terminal_height)) {
+    return false;
+  }
+
+  // Make previous bottom symbol not bold
+  if ((col_start >= 1) && (col_start <= _terminal_height)) {
+    bool bold = (rand_values[0] % 100) > 90;
+    cells[cells_num++] = {col_start - 1, col_heads[col], bold};
+  }
+
+  // Place new random symbol to bottom of column
+  if (col_start < _terminal_height) {
+    col_heads[col] = getRandSymbol(rand_values[1], rand_values[2]);
+    cells[cells_num++] = {col_start, col_heads[col], true};
+  }
+
+  // Change random symbol in column
+  int row_id = rand_values[3] % _terminal_height;
+  if ((row_id >= col_end) && (row_id < col_start)) {
+    bool bold = (rand_values[4] % 100) > 60;
+    cells[cells_num++] = {row_id, getRandSymbol(rand_values[5], rand_values[6]),
+                          bold};
+  }
+
+  // Start showing some of real symbols in column
+  int fade_row_id = (col_end - 1) - rand_values[7] % tail_length;
+  if ((fade_row_id >= 0) && (fade_row_id < _terminal_height)) {
+    cells[cells_num++] = {fade_row_id, grid->get(col, fade_row_id), false};
+  }
+
+  // Show real text symbol
+  if ((text_start >= 0) && (text_start < _terminal_height)) {
+    cells[cells_num++] = {text_start, grid->get(col, text_start), false};
+  }
+  return true;
+}
+
+wchar_t MatrixAnimation::getRandSymbol(uint32_t type_value,
+                                       uint32_t symbol_value) const {
+  int type = type_value % (config.without_japanese ? 600 : 1000);
 
   if (type < 100) {
-    return 0x30 + rand() % 9;
+    return 0x30 + symbol_value % 9;
   }
   if (type < 300) {
-    return 0x41 + rand() % 26;
+    return 0x41 + symbol_value % 26;
   }
   if (type < 600) {
-    return 0x61 + rand() % 26;
+    return 0x61 + symbol_value % 26;
   }
-  return 0xff66 + rand() % 58;
+  return 0xff66 + symbol_value % 58;
 }
@@ -21,21 +21,52 @@ Mattext is distributed in the hope that it will be useful,
 
 #pragma once
 
+#include <memory>
 #include <vector>
 #include "animation_generic.h"
 
+class WorkerPool;
+
 class MatrixAnimation : public GenericAnimation {
  public:
-  using GenericAnimation::GenericAnimation;
+  MatrixAnimation(const Config &config, const Terminal &terminal,
+                  Stats &stats, const std::string &name);
+  ~MatrixAnimation();
 
  protected:
+  struct Cell {
+    int row;
+    wchar_t symbol;
+    bool bold;
+  };
+  // Column can't change more cells than this during one tick
+  static const size_t col_max_cells = 5;
+  // Random values used by one column during one tick
+  static const size_t col_rand_values = 8;
+
   std::vector<size_t> col_lengths;
   std::vector<size_t> col_offsets;
   size_t max_col_length;
   size_t tick_id;
   size_t tail_length = 10;
+  std::vector<wchar_t> col_heads;
 
   void init() override;
-  virtual void tick(ev::timer &w, int revents) override;
-  wchar_t getRandSymbol();
+  void tick(ev::timer &w, int revents) override;
+  // Computes changes of one column and places them to cells, returns false
+  // if column has finished. Is called from several threads at once, so should
+  // not touch anything except column's own data.
+  virtual bool updateColumn(int col, const uint32_t *rand_values, Cell *cells,
+                            size_t &cells_num);
+  wchar_t getRandSymbol(uint32_t type_value, uint32_t symbol_value) const;
+
+ private:
+  std::vector<Cell> cells;
+  std::vector<size_t> col_cells_num;
+  // Not vector<bool>, elements are written from different threads
+  std::vector<char> col_active;
+  std::vector<uint32_t> rand_values;
+  std::unique_ptr<WorkerPool> workers;
+
+  void updateColumns(size_t begin, size_t end);
 };
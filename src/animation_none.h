@@ -26,7 +26,8 @@ Mattext is distributed in the hope that it will be useful,
 class NoneAnimation : public Animation {
  public:
   NoneAnimation(const Terminal &terminal);
-  void play(const Text &text, std::function<void()> on_stop) override;
+  void onStop(std::function<void()> on_stop) override;
+  void play(const Text &text) override;
   void stop() override;
   bool isPlaying() override;
 
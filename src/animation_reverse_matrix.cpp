@@ -20,63 +20,50 @@ Mattext is distributed in the hope that it will be useful,
 *******************************************************************************/
 
 #include "animation_reverse_matrix.h"
-#include <stdlib.h>
 #include "config.h"
 #include "file_reader.h"
 #include "terminal.h"
 
-void ReverseMatrixAnimation::tick(ev::timer& /*w*/, int /*revents*/) {
-  int _terminal_height = static_cast<int>(terminal_height);
-  bool stopped = true;
+bool ReverseMatrixAnimation::updateColumn(int col, const uint32_t *rand_values,
+                                          Cell *cells, size_t &cells_num) {
+  const int _terminal_height = static_cast<int>(terminal_height);
+  int col_start = _terminal_height - 1 - tick_id + col_offsets[col];
+  int col_end = col_start + col_lengths[col];
+  int text_start = col_end + tail_length + 1;
 
-  for (int col = 0; col < terminal_width; ++col) {
-    int col_start = _terminal_height - 1 - tick_id + col_offsets[col];
-    int col_end = col_start + col_lengths[col];
-    int text_start = col_end + tail_length + 1;
-
-    if ((col_start >= _terminal_height) || (text_start < 0)) {
-      continue;
-    }
-
-    stopped = false;
-
-    // Make previous bottom symbol not bold
-    if ((col_start >= 0) && (col_start <= _terminal_height - 2)) {
-      bool bold = (rand() % 100) > 90;
-      terminal.set(col, col_start + 1, terminal.get(col, col_start + 1), bold,
-                   ColorGreen, ColorBlack);
-    }
+  if ((col_start >= _terminal_height) || (text_start < 0)) {
+    return false;
+  }
 
-    // Place new random symbol to bottom of column
-    if (col_start < _terminal_height) {
-      terminal.set(col, col_start, getRandSymbol(), true, ColorGreen,
-                   ColorBlack);
-    }
+  // Make previous bottom symbol not bold
+  if ((col_start >= 0) && (col_start <= _terminal_height - 2)) {
+    bool bold = (rand_values[0] % 100) > 90;
+    cells[cells_num++] = {col_start + 1, col_heads[col], bold};
+  }
 
-    // Change random symbol in column
-    int row_id = rand() % _terminal_height;
-    if ((row_id >= col_end) && (row_id < col_start)) {
-      bool bold = (rand() % 100) > 60;
-      terminal.set(col, row_id, getRandSymbol(), bold, ColorGreen, ColorBlack);
-    }
+  // Place new random symbol to bottom of column
+  if (col_start < _terminal_height) {
+    col_heads[col] = getRandSymbol(rand_values[1], rand_values[2]);
+    cells[cells_num++] = {col_start, col_heads[col], true};
+  }
 
-    // Start showing some of real symbols in column
-    int fade_row_id = (col_end + 1) + rand() % tail_length;
-    if ((fade_row_id >= 0) && (fade_row_id < _terminal_height)) {
-      terminal.set(col, fade_row_id, text->get(col, fade_row_id), false,
-                   ColorGreen, ColorBlack);
-    }
+  // Change random symbol in column
+  int row_id = rand_values[3] % _terminal_height;
+  if ((row_id >= col_end) && (row_id < col_start)) {
+    bool bold = (rand_values[4] % 100) > 60;
+    cells[cells_num++] = {row_id, getRandSymbol(rand_values[5], rand_values[6]),
+                          bold};
+  }
 
-    // Show real text symbol
-    if ((text_start >= 0) && (text_start < _terminal_height)) {
-      terminal.set(col, text_start, text->get(col, text_start), false,
-                   ColorGreen, ColorBlack);
-    }
+  // Start showing some of real symbols in column
+  int fade_row_id = (col_end + 1) + rand_values[7] % tail_length;
+  if ((fade_row_id >= 0) && (fade_row_id < _terminal_height)) {
+    cells[cells_num++] = {fade_row_id, grid->get(col, fade_row_id), false};
   }
-  ++tick_id;
-  terminal.show();
 
-  if (stopped) {
-    stop();
+  // Show real text symbol
+  if ((text_start >= 0) && (text_start < _terminal_height)) {
+    cells[cells_num++] = {text_start, grid->get(col, text_start), false};
   }
+  return true;
 }
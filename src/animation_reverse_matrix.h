@@ -28,5 +28,6 @@ class ReverseMatrixAnimation : public MatrixAnimation {
   using MatrixAnimation::MatrixAnimation;
 
  private:
-  void tick(ev::timer &w, int revents) override;
+  bool updateColumn(int col, const uint32_t *rand_values, Cell *cells,
+                    size_t &cells_num) override;
 };
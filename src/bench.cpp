@@ -0,0 +1,96 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "bench.h"
+#include <algorithm>
+#include <numeric>
+#include "config.h"
+#include "manager_interactive.h"
+#include "terminal_headless.h"
+
+Bench::Bench(const Config &config, const HeadlessTerminal &terminal,
+             ManagerInteractive &manager)
+    : config(config), terminal(terminal) {
+  terminal.onShow([this]() { this->frameShown(); });
+  manager.onPageShown([this]() { this->pageShown(); });
+  start_time = Clock::now();
+  frame_start_time = start_time;
+}
+
+void Bench::frameShown() {
+  if (finished) {
+    return;
+  }
+  const auto now = Clock::now();
+  frame_times.push_back(
+      std::chrono::duration<double, std::micro>(now - frame_start_time)
+          .count());
+  frame_start_time = now;
+}
+
+void Bench::pageShown() {
+  if (finished) {
+    return;
+  }
+  ++pages_shown;
+  if (pages_shown < static_cast<size_t>(config.bench_pages)) {
+    // Time spent on reading next page is not a part of any frame
+    terminal.press('f');
+    frame_start_time = Clock::now();
+    return;
+  }
+  finished = true;
+  end_time = Clock::now();
+  terminal.press('q');
+}
+
+void Bench::report(FILE *out) const {
+  const double total =
+      std::chrono::duration<double>(end_time - start_time).count();
+  std::vector<double> times(frame_times);
+  std::sort(times.begin(), times.end());
+
+  auto percentile = [&times](double p) {
+    if (times.empty()) {
+      return 0.;
+    }
+    return times[std::min(times.size() - 1,
+                          static_cast<size_t>(p * times.size()))];
+  };
+  const double average =
+      times.empty()
+          ? 0.
+          : std::accumulate(times.begin(), times.end(), 0.) / times.size();
+
+  fprintf(out, "terminal: %zux%zu\n", terminal.getWidth(),
+          terminal.getHeight());
+  fprintf(out, "pages: %zu in %.3f s, %.1f pages/s\n", pages_shown, total,
+          pages_shown / total);
+  fprintf(out, "frames: %zu, %.1f frames/s\n", times.size(),
+          times.size() / total);
+  fprintf(out, "cells: %zu, %.0f cells/s\n", terminal.cellsSet(),
+          terminal.cellsSet() / total);
+  fprintf(out,
+          "frame time, us: avg %.1f, p50 %.1f, p90 %.1f, p99 %.1f, "
+          "max %.1f\n",
+          average, percentile(0.5), percentile(0.9), percentile(0.99),
+          times.empty() ? 0. : times.back());
+}
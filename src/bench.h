@@ -0,0 +1,53 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+class Config;
+class HeadlessTerminal;
+class ManagerInteractive;
+
+// Turns pages in a headless terminal as fast as possible and collects
+// frame timings
+class Bench {
+ public:
+  Bench(const Config &config, const HeadlessTerminal &terminal,
+        ManagerInteractive &manager);
+  void report(FILE *out) const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  const Config &config;
+  const HeadlessTerminal &terminal;
+  size_t pages_shown = 0;
+  bool finished = false;
+  Clock::time_point start_time;
+  Clock::time_point end_time;
+  Clock::time_point frame_start_time;
+  std::vector<double> frame_times;
+
+  void frameShown();
+  void pageShown();
+};
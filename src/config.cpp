@@ -22,6 +22,7 @@ Mattext is distributed in the hope that it will be useful,
 #include "config.h"
 #include <argp.h>
 #include <stdlib.h>
+#include <time.h>
 #include <string>
 #include "animation.h"
 
@@ -39,6 +40,17 @@ static bool getIntArg(int &value, char *str) {
   return true;
 }
 
+static bool getUInt64Arg(uint64_t &value, char *str) {
+  char *end = nullptr;
+  uint64_t res = strtoull(str, &end, 0);
+
+  if ((str == end) || *end) {
+    return false;
+  }
+  value = res;
+  return true;
+}
+
 static error_t parseOptions(int key, char *arg, struct argp_state *state) {
   Config *config = reinterpret_cast<Config *>(state->input);
 
@@ -104,6 +116,53 @@ static error_t parseOptions(int key, char *arg, struct argp_state *state) {
         return ARGP_ERR_UNKNOWN;
       }
       break;
+    case -3:
+      if (!getUInt64Arg(config->seed, arg)) {
+        return ARGP_ERR_UNKNOWN;
+      }
+      break;
+    case -4:
+      if (!getIntArg(config->width, arg) || (config->width < 1)) {
+        return ARGP_ERR_UNKNOWN;
+      }
+      break;
+    case -5:
+      if (!getIntArg(config->height, arg) || (config->height < 1)) {
+        return ARGP_ERR_UNKNOWN;
+      }
+      break;
+    case -6:
+      if (!getIntArg(config->bench_pages, arg) || (config->bench_pages < 1)) {
+        return ARGP_ERR_UNKNOWN;
+      }
+      break;
+    case -7:
+      config->stats = true;
+      if (arg) {
+        config->stats_file = arg;
+      }
+      break;
+    case -8:
+      config->trace_file = arg;
+      break;
+    case -9:
+      config->hud = true;
+      break;
+    case -10:
+      config->counters = true;
+      if (arg) {
+        config->counters_file = arg;
+      }
+      break;
+    case -11:
+      config->metrics_file = arg;
+      break;
+    case -12:
+      if (!getIntArg(config->metrics_interval, arg)
+          || (config->metrics_interval < 1)) {
+        return ARGP_ERR_UNKNOWN;
+      }
+      break;
     default:
       break;
   }
@@ -141,10 +200,60 @@ Config::Config(int argc, char *argv[]) {
        6},
       {"tab-width", 't', "width", 0,
        "Tab width, minimum 1, default " MAKE_STR(DEFAULT_TAB_WIDTH), 7},
+      {"seed", -3, "value", 0,
+       "Seed for animations, the same seed gives the same frames, default is "
+       "current time",
+       8},
+      {"bench", -6, "pages", 0,
+       "Show specified number of pages as fast as possible in a headless "
+       "terminal and print frame statistics",
+       9},
+      {"width", -4, "value", 0,
+       "Width of headless terminal, default " MAKE_STR(
+           DEFAULT_WIDTH) ", or of text in plain mode, terminal size is not "
+                          "queried then",
+       9},
+      {"height", -5, "value", 0,
+       "Height of headless terminal or of page in plain mode, default "
+       MAKE_STR(DEFAULT_HEIGHT),
+       9},
+      {"stats", -7, "file", OPTION_ARG_OPTIONAL,
+       "Print timings of animation ticks, screen updates, reads and page "
+       "layout, with hardware counters if permitted, on exit, to stderr or "
+       "to specified file",
+       10},
+      {"trace", -8, "file", 0,
+       "Write trace of key presses, reads, animation ticks and screen updates "
+       "to file in Chrome trace event format",
+       10},
+      {"hud", -9, nullptr, 0,
+       "Show frame rate, tick time, output and input rates in the top right "
+       "corner, h key toggles it",
+       10},
+      {"counters", -10, "file", OPTION_ARG_OPTIONAL,
+       "Print input counters on exit and on SIGUSR1, to stderr or to "
+       "specified file, in JSON if file name ends with .json. Without file "
+       "interactive mode writes SIGUSR1 counters to "
+       "$TMPDIR/mattext-counters-PID.txt",
+       10},
+      {"metrics-file", -11, "file", 0,
+       "Periodically replace file with frame times, input and memory metrics "
+       "in Prometheus text format",
+       10},
+      {"metrics-interval", -12, "seconds", 0,
+       "Interval between metrics file updates, default " MAKE_STR(
+           DEFAULT_METRICS_INTERVAL),
+       10},
       {nullptr, 0, nullptr, 0, nullptr, 0}};
 
   argp argp_opts = {options, parseOptions, "file[, file, ...]",
                     nullptr, nullptr,      nullptr,
                     nullptr};
+  seed = time(nullptr);
   argp_parse(&argp_opts, argc, argv, 0, nullptr, this);
+
+  if (bench_pages) {
+    delay = 0;
+    infinite = true;
+  }
 }
@@ -21,12 +21,16 @@ Mattext is distributed in the hope that it will be useful,
 
 #pragma once
 
+#include <stdint.h>
 #include <list>
 #include <string>
 
 #define DEFAULT_DELAY 60
 #define DEFAULT_BLOCK_LINES 1
 #define DEFAULT_TAB_WIDTH 4
+#define DEFAULT_WIDTH 80
+#define DEFAULT_HEIGHT 24
+#define DEFAULT_METRICS_INTERVAL 15
 
 class Config {
  public:
@@ -44,6 +48,19 @@ class Config {
   std::string animation_next{"matrix"};
   std::string animation_prev{"reverse_matrix"};
   int tab_width = DEFAULT_TAB_WIDTH;
+  uint64_t seed = 0;
+  int width = 0;
+  int height = 0;
+  int bench_pages = 0;
+  bool stats = false;
+  std::string stats_file;
+  std::string trace_file;
+  bool hud = false;
+  bool counters = false;
+  std::string counters_file;
+  std::string metrics_file;
+  int metrics_interval = DEFAULT_METRICS_INTERVAL;
 
+  Config() = default;
   Config(int argc, char *argv[]);
 };
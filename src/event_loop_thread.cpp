@@ -0,0 +1,38 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "event_loop_thread.h"
+
+EventLoopThread::EventLoopThread() {
+  stop_watcher.set<EventLoopThread, &EventLoopThread::stopCb>(this);
+  stop_watcher.start();
+  thread = std::thread([]() { ev_run(EV_DEFAULT, 0); });
+}
+
+EventLoopThread::~EventLoopThread() {
+  stop_watcher.send();
+  thread.join();
+  stop_watcher.stop();
+}
+
+void EventLoopThread::stopCb(ev::async &w, int /*revents*/) {
+  w.loop.break_loop(ev::ALL);
+}
@@ -0,0 +1,42 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <ev++.h>
+#include <thread>
+
+// Runs default event loop on its own thread while main thread is busy with
+// plain mode stages, so metrics timer and SIGUSR1 watcher keep working.
+// Watchers have to be started before construction and stopped after
+// destruction.
+class EventLoopThread {
+ public:
+  EventLoopThread();
+  // Stops the loop and waits for the thread
+  ~EventLoopThread();
+
+ private:
+  ev::async stop_watcher;
+  std::thread thread;
+
+  void stopCb(ev::async &w, int revents);
+};
@@ -20,20 +20,18 @@ Mattext is distributed in the hope that it will be useful,
 *******************************************************************************/
 
 #include "file_backward_reader.h"
-#include <string.h>
 #include <wchar.h>
 #include <stdexcept>
 #include "config.h"
-#include "file_io.h"
+#include "page_buffer.h"
+#include "symbol_input.h"
 
-BackwardReader::BackwardReader(std::vector<std::vector<wchar_t>> &lines,
-                               std::vector<size_t> &line_lens,
-                               const Config &config)
-    : lines(lines), line_lens(line_lens), config(config) {}
+BackwardReader::BackwardReader(PageBuffer &page, const Config &config)
+    : page(page), config(config) {}
 
 void BackwardReader::newPage() {
   // cache size should be equal to longest possible string
-  const size_t cache_size = lines.size() * (lines[0].size() - 2) + 1;
+  const size_t cache_size = page.rows() * page.width() + 1;
   if (cache.size() != cache_size) {
     cache.resize(cache_size);
   }
@@ -48,7 +46,7 @@ void BackwardReader::directionChanged() {
   remaining_spaces = 0;
 }
 
-bool BackwardReader::read(FileIO &f) {
+bool BackwardReader::read(SymbolInput &f) {
   if (cache_len && processCache()) {
     return true;
   }
@@ -67,11 +65,11 @@ bool BackwardReader::read(FileIO &f) {
 }
 
 bool BackwardReader::processCache() {
-  size_t lines_remaining = lines.size() - lines_read;
+  size_t lines_remaining = page.rows() - lines_read;
   if (!lines_remaining) {
     return true;
   }
-  const size_t line_len = lines[0].size() - 2;
+  const size_t line_len = page.width();
   const size_t cache_end = cache_start + cache_len;
   size_t cache_lines = cache_len / line_len + (cache_len % line_len ? 1 : 0);
   if ((cache[cache_end - 1] == '\n') && (cache_lines > 1)
@@ -93,17 +91,16 @@ bool BackwardReader::processCache() {
       ++copy_len;
     }
     size_t line_len = copy_len;
-    memcpy(lines[current_line].data(), cache.data() + start,
-           copy_len * mbchar_size);
+    page.set(current_line, 0, cache.data() + start, copy_len);
 
-    if (lines[current_line][copy_len - 1] != '\n') {
-      lines[current_line][copy_len] = '\n';
-      lines[current_line][copy_len + 1] = '\0';
+    if (cache[start + copy_len - 1] != '\n') {
+      page.set(current_line, copy_len, L'\n');
+      page.set(current_line, copy_len + 1, L'\0');
     } else {
       --line_len;
-      lines[current_line][copy_len] = '\0';
+      page.set(current_line, copy_len, L'\0');
     }
-    line_lens[current_line] = line_len;
+    page.lineLen(current_line) = line_len;
     if (longest_line_len < line_len) {
       longest_line_len = line_len;
     }
@@ -122,14 +119,14 @@ bool BackwardReader::processCache() {
   return false;
 }
 
-bool BackwardReader::fillCache(FileIO &f) {
+bool BackwardReader::fillCache(SymbolInput &f) {
   if (cache_len == cache.size()) {
     return true;
   }
 
   while (true) {
     auto &cur_symbol = cache[cache.size() - 1 - cache_len];
-    FileIO::Status ret = FileIO::Status::Ok;
+    SymbolInput::Status ret = SymbolInput::Status::Ok;
 
     if (remaining_spaces) {
       cur_symbol = ' ';
@@ -137,10 +134,10 @@ bool BackwardReader::fillCache(FileIO &f) {
     } else {
       ret = f.read(cur_symbol);
     }
-    if (ret == FileIO::Status::WouldBlock) {
+    if (ret == SymbolInput::Status::WouldBlock) {
       return false;
     }
-    if (ret == FileIO::Status::End) {
+    if (ret == SymbolInput::Status::End) {
       first_page = true;
       return true;
     }
@@ -170,58 +167,20 @@ size_t BackwardReader::linesRead() const {
   return lines_read;
 }
 
-wchar_t BackwardReader::get(size_t _column, size_t _row) const {
-  const size_t height = lines.size();
-  const size_t width = lines[0].size() - 2;
-  const int first_line = lines.size() - lines_read;
-  int start_row = -first_line;
-  if (config.center_vert) {
-    start_row += ((height - lines_read) / 2);
-  } else if (first_page) {
-    start_row = 0;
-  }
-  const int row = static_cast<int>(_row) - start_row;
-
-  if ((row < first_line) || (row >= static_cast<int>(lines.size()))) {
-    return L' ';
-  }
-
-  size_t line_len =
-      config.center_horiz_longest ? longest_line_len : line_lens[row];
-  int start_column = config.center_horiz ? ((width - line_len) / 2) : 0;
-  int column = static_cast<int>(_column) - start_column;
-
-  if ((column < 0) || (column >= static_cast<int>(line_lens[row]))) {
-    return L' ';
-  }
-
-  if ((lines[row][column] == '\n') || (lines[row][column] == '\r')) {
-    return L' ';
-  }
-
-  return lines[row][column];
+PageShape BackwardReader::getShape() const {
+  PageShape shape;
+  shape.first_row = page.rows() - lines_read;
+  shape.lines = lines_read;
+  // The first page of file is shown at the bottom
+  shape.top = first_page ? shape.first_row : 0;
+  shape.longest_line_len = longest_line_len;
+  return shape;
 }
 
-std::wstring BackwardReader::getLine() const {
-  if (current_out_line_id >= lines.size()) {
-    return L"";
+bool BackwardReader::nextLine(size_t &row) const {
+  if (current_out_line_id >= page.rows()) {
+    return false;
   }
-  if (!config.center_horiz) {
-    return lines[current_out_line_id++].data();
-  }
-
-  const size_t width = lines[0].size() - 2;
-  size_t line_len = config.center_horiz_longest
-                        ? longest_line_len
-                        : line_lens[current_out_line_id];
-  size_t padding = (width - line_len) / 2;
-  std::wstring str;
-  if (padding) {
-    str.append(padding, L' ');
-  }
-
-  str.append(lines[current_out_line_id].data());
-  ++current_out_line_id;
-
-  return str;
+  row = current_out_line_id++;
+  return true;
 }
@@ -25,21 +25,20 @@ Mattext is distributed in the hope that it will be useful,
 #include "file_reader_logic.h"
 
 class Config;
+class PageBuffer;
 
 class BackwardReader : public FileReaderLogic {
  public:
-  BackwardReader(std::vector<std::vector<wchar_t>> &lines,
-                 std::vector<size_t> &line_lens, const Config &config);
+  BackwardReader(PageBuffer &page, const Config &config);
   void newPage() override;
   void directionChanged() override;
-  bool read(FileIO &f) override;
+  bool read(SymbolInput &f) override;
   size_t linesRead() const override;
-  wchar_t get(size_t column, size_t row) const override;
-  std::wstring getLine() const override;
+  PageShape getShape() const override;
+  bool nextLine(size_t &row) const override;
 
  private:
-  std::vector<std::vector<wchar_t>> &lines;
-  std::vector<size_t> &line_lens;
+  PageBuffer &page;
   const Config &config;
   std::vector<wchar_t> cache;
   size_t cache_len = 0;
@@ -52,6 +51,6 @@ class BackwardReader : public FileReaderLogic {
   bool first_page;
   size_t remaining_spaces = 0;
 
-  bool fillCache(FileIO &f);
+  bool fillCache(SymbolInput &f);
   bool processCache();
 };
@@ -21,10 +21,14 @@ Mattext is distributed in the hope that it will be useful,
 
 #include "file_cache.h"
 #include <stdlib.h>
+#include "io_counters.h"
+
+FileCache::FileCache(IoCounters &counters) : counters(counters) {}
 
 void FileCache::addForward(char byte) {
   cur = (start + len) % cache_max_len;
   if (len == cache_max_len) {
+    ++counters.cache_evicted_bytes;
     incCounter(start);
     cache[cur] = byte;
   } else {
@@ -24,8 +24,11 @@ Mattext is distributed in the hope that it will be useful,
 #include <stddef.h>
 #include <vector>
 
+struct IoCounters;
+
 class FileCache {
  public:
+  FileCache(IoCounters &counters);
   void addForward(char byte);
   bool readForward(char &byte);
   bool readBackward(char &byte);
@@ -41,6 +44,7 @@ class FileCache {
   size_t cur = 0;
   enum class Reached { Start, End, Ok };
   Reached status = Reached::End;
+  IoCounters &counters;
 
   static inline void incCounter(size_t &counter);
   static inline void decCounter(size_t &counter);
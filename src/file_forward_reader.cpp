@@ -24,12 +24,11 @@ Mattext is distributed in the hope that it will be useful,
 #include <wchar.h>
 #include <stdexcept>
 #include "config.h"
-#include "file_io.h"
+#include "page_buffer.h"
+#include "symbol_input.h"
 
-ForwardReader::ForwardReader(std::vector<std::vector<wchar_t>> &lines,
-                             std::vector<size_t> &line_lens,
-                             const Config &config)
-    : lines(lines), line_lens(line_lens), config(config) {}
+ForwardReader::ForwardReader(PageBuffer &page, const Config &config)
+    : page(page), config(config) {}
 
 void ForwardReader::newPage() {
   current_line_id = 0;
@@ -41,8 +40,8 @@ void ForwardReader::directionChanged() {
   remaining_spaces = 0;
 }
 
-bool ForwardReader::read(FileIO &f) {
-  if (current_line_id == lines.size()) {
+bool ForwardReader::read(SymbolInput &f) {
+  if (current_line_id == page.rows()) {
     return true;
   }
 
@@ -51,14 +50,13 @@ bool ForwardReader::read(FileIO &f) {
       return false;
     }
 
-    auto &cur_line = lines[current_line_id];
-    auto &line_len = line_lens[current_line_id];
+    auto &line_len = page.lineLen(current_line_id);
 
     if (!line_len) {
       return true;
     }
 
-    if (cur_line[line_len - 1] == '\n') {
+    if (page.get(current_line_id, line_len - 1) == '\n') {
       --line_len;
     }
 
@@ -67,22 +65,22 @@ bool ForwardReader::read(FileIO &f) {
     }
     ++current_line_id;
 
-    if (current_line_id == lines.size()) {
+    if (current_line_id == page.rows()) {
       return true;
     }
   }
 }
 
-bool ForwardReader::readLine(FileIO &f) {
-  auto &cur_symbol_id = line_lens[current_line_id];
-  const size_t line_max_len = lines[0].size() - 1;
+bool ForwardReader::readLine(SymbolInput &f) {
+  auto &cur_symbol_id = page.lineLen(current_line_id);
+  const size_t line_max_len = page.width() + 1;
   if (cur_symbol_id == line_max_len) {
     return true;
   }
 
   while (true) {
-    auto &cur_symbol = lines[current_line_id][cur_symbol_id];
-    FileIO::Status ret = FileIO::Status::Ok;
+    wchar_t cur_symbol;
+    SymbolInput::Status ret = SymbolInput::Status::Ok;
     bool file_read = false;
 
     if (remaining_spaces) {
@@ -92,11 +90,10 @@ bool ForwardReader::readLine(FileIO &f) {
       ret = f.read(cur_symbol);
       file_read = true;
     }
-    if (ret == FileIO::Status::WouldBlock) {
-      return false;
-    }
-    if (ret == FileIO::Status::End) {
-      return true;
+    if (ret != SymbolInput::Status::Ok) {
+      // Line read so far ends here
+      page.set(current_line_id, cur_symbol_id, L'\0');
+      return ret == SymbolInput::Status::End;
     }
     ++cur_symbol_id;
 
@@ -106,6 +103,7 @@ bool ForwardReader::readLine(FileIO &f) {
     }
 
     if ((cur_symbol != '\n') && (cur_symbol_id < line_max_len)) {
+      page.set(current_line_id, cur_symbol_id - 1, cur_symbol);
       continue;
     }
 
@@ -117,7 +115,8 @@ bool ForwardReader::readLine(FileIO &f) {
       }
       cur_symbol = '\n';
     }
-    lines[current_line_id][cur_symbol_id] = '\0';
+    page.set(current_line_id, cur_symbol_id - 1, cur_symbol);
+    page.set(current_line_id, cur_symbol_id, L'\0');
     return true;
   }
 }
@@ -126,52 +125,17 @@ size_t ForwardReader::linesRead() const {
   return current_line_id;
 }
 
-wchar_t ForwardReader::get(size_t _column, size_t _row) const {
-  const size_t height = lines.size();
-  const size_t width = lines[0].size() - 2;
-  int start_row = config.center_vert ? ((height - current_line_id) / 2) : 0;
-  int row = static_cast<int>(_row) - start_row;
-
-  if ((row < 0) || (row >= static_cast<int>(current_line_id))) {
-    return L' ';
-  }
-
-  size_t line_len =
-      config.center_horiz_longest ? longest_line_len : line_lens[row];
-  int start_column = config.center_horiz ? ((width - line_len) / 2) : 0;
-  int column = static_cast<int>(_column) - start_column;
-
-  if ((column < 0) || (column >= static_cast<int>(line_lens[row]))) {
-    return L' ';
-  }
-
-  if ((lines[row][column] == '\n') || (lines[row][column] == '\r')) {
-    return L' ';
-  }
-
-  return lines[row][column];
+PageShape ForwardReader::getShape() const {
+  PageShape shape;
+  shape.lines = current_line_id;
+  shape.longest_line_len = longest_line_len;
+  return shape;
 }
 
-std::wstring ForwardReader::getLine() const {
+bool ForwardReader::nextLine(size_t &row) const {
   if (current_out_line_id >= current_line_id) {
-    return L"";
-  }
-  if (!config.center_horiz) {
-    return lines[current_out_line_id++].data();
+    return false;
   }
-
-  const size_t width = lines[0].size() - 2;
-  size_t line_len = config.center_horiz_longest
-                        ? longest_line_len
-                        : line_lens[current_out_line_id];
-  size_t padding = (width - line_len) / 2;
-  std::wstring str;
-  if (padding) {
-    str.append(padding, L' ');
-  }
-
-  str.append(lines[current_out_line_id].data());
-  ++current_out_line_id;
-
-  return str;
+  row = current_out_line_id++;
+  return true;
 }
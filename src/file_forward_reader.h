@@ -21,30 +21,28 @@ Mattext is distributed in the hope that it will be useful,
 
 #pragma once
 
-#include <vector>
 #include "file_reader_logic.h"
 
 class Config;
+class PageBuffer;
 
 class ForwardReader : public FileReaderLogic {
  public:
-  ForwardReader(std::vector<std::vector<wchar_t>> &lines,
-                std::vector<size_t> &line_lens, const Config &config);
+  ForwardReader(PageBuffer &page, const Config &config);
   void newPage() override;
   void directionChanged() override;
-  bool read(FileIO &f) override;
+  bool read(SymbolInput &f) override;
   size_t linesRead() const override;
-  wchar_t get(size_t column, size_t row) const override;
-  std::wstring getLine() const override;
+  PageShape getShape() const override;
+  bool nextLine(size_t &row) const override;
 
  private:
-  std::vector<std::vector<wchar_t>> &lines;
-  std::vector<size_t> &line_lens;
+  PageBuffer &page;
   const Config &config;
   size_t current_line_id;
   size_t longest_line_len;
   mutable size_t current_out_line_id;
   size_t remaining_spaces = 0;
 
-  bool readLine(FileIO &f);
+  bool readLine(SymbolInput &f);
 };
@@ -27,8 +27,10 @@ Mattext is distributed in the hope that it will be useful,
 #include <sstream>
 #include <stdexcept>
 #include "file_cache.h"
+#include "io_counters.h"
 
-FileIO::FileIO(const char *name) : name(name) {
+FileIO::FileIO(const char *name, IoCounters &counters)
+    : name(name), counters(counters) {
   fd = open(name, O_RDONLY | O_NONBLOCK);
   if (fd == -1) {
     std::ostringstream err;
@@ -43,12 +45,15 @@ FileIO::FileIO(const char *name) : name(name) {
     throw std::runtime_error(err.str());
   }
   if (S_ISFIFO(file_stat.st_mode)) {
-    cache = std::make_unique<FileCache>();
+    cache = std::make_unique<FileCache>(counters);
   }
 }
 
-FileIO::FileIO(int stdin_fd)
-    : fd(stdin_fd), name("stdin"), cache(std::make_unique<FileCache>()) {
+FileIO::FileIO(int stdin_fd, IoCounters &counters)
+    : fd(stdin_fd),
+      name("stdin"),
+      cache(std::make_unique<FileCache>(counters)),
+      counters(counters) {
   int flags = fcntl(fd, F_GETFL, 0);
   if (flags < 0) {
     std::ostringstream err;
@@ -66,29 +71,67 @@ FileIO::~FileIO() {
   close(fd);
 }
 
+ssize_t FileIO::readFd(char *byte_ptr) {
+  ++counters.syscalls;
+  return ::read(fd, byte_ptr, 1);
+}
+
+off_t FileIO::seek(off_t offset, int whence) {
+  ++counters.syscalls;
+  ++counters.seeks;
+  return lseek(fd, offset, whence);
+}
+
 FileIO::Status FileIO::readByteForward(char *byte_ptr) {
-  if (cache && cache->readForward(*byte_ptr)) {
-    return Status::Ok;
+  if (cache) {
+    if (cache->readForward(*byte_ptr)) {
+      ++counters.cache_hits;
+      return Status::Ok;
+    }
+    ++counters.cache_misses;
   }
-  int ret = ::read(fd, byte_ptr, 1);
+  int ret = readFd(byte_ptr);
 
   if (!ret) {
     return Status::End;
   }
   if (ret == -1) {
     if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+      ++counters.would_block;
       return Status::WouldBlock;
     }
     std::ostringstream err;
     err << "Can't read from file '" << name << "': " << strerror(errno);
     throw std::runtime_error(err.str());
   }
+  ++counters.bytes_read;
   if (cache) {
     cache->addForward(*byte_ptr);
   }
   return Status::Ok;
 }
 
+FileIO::Status FileIO::readChunk(char *buffer, size_t size, size_t &len) {
+  ssize_t ret;
+  do {
+    ++counters.syscalls;
+    ret = ::read(fd, buffer, size);
+  } while ((ret == -1) && (errno == EINTR));
+
+  if (ret == -1) {
+    if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+      ++counters.would_block;
+      return Status::WouldBlock;
+    }
+    std::ostringstream err;
+    err << "Can't read from file '" << name << "': " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+  len = ret;
+  counters.bytes_read += len;
+  return len ? Status::Ok : Status::End;
+}
+
 FileIO::Status FileIO::readForward(wchar_t &symbol) {
   mbstate_t mbs;
   symbol = '\0';
@@ -127,14 +170,15 @@ FileIO::Status FileIO::readForward(wchar_t &symbol) {
 FileIO::Status FileIO::readByteBackward(char *byte_ptr) {
   if (cache) {
     if (cache->readBackward(*byte_ptr)) {
+      ++counters.cache_hits;
       return Status::Ok;
     }
     return Status::End;
   }
 
-  if (lseek(fd, -1, SEEK_CUR) == -1) {
+  if (seek(-1, SEEK_CUR) == -1) {
     int seek_errno = errno;
-    if (lseek(fd, 0, SEEK_CUR)) {
+    if (seek(0, SEEK_CUR)) {
       std::ostringstream err;
       err << "Can't read from file '" << name
           << "': seek failed: " << strerror(seek_errno);
@@ -143,17 +187,19 @@ FileIO::Status FileIO::readByteBackward(char *byte_ptr) {
     return Status::End;
   }
   errno = 0;
-  int ret = ::read(fd, byte_ptr, 1);
+  int ret = readFd(byte_ptr);
 
   if (ret <= 0) {
     if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+      ++counters.would_block;
       return Status::WouldBlock;
     }
     std::ostringstream err;
     err << "Can't read from file '" << name << "': " << strerror(errno);
     throw std::runtime_error(err.str());
   }
-  if (lseek(fd, -1, SEEK_CUR) == -1) {
+  ++counters.bytes_read;
+  if (seek(-1, SEEK_CUR) == -1) {
     std::ostringstream err;
     err << "Can't read from file '" << name
         << "': seek failed: " << strerror(errno);
@@ -207,13 +253,13 @@ void FileIO::newPage(Direction _direction) {
       if (cache) {
         cache->rewindToStart();
       } else {
-        ret = lseek(fd, 0, SEEK_SET);
+        ret = seek(0, SEEK_SET);
       }
     } else {
       if (cache) {
         cache->rewindToEnd();
       } else {
-        ret = lseek(fd, 0, SEEK_END);
+        ret = seek(0, SEEK_END);
       }
     }
     if (ret == -1) {
@@ -233,7 +279,7 @@ void FileIO::newPage(Direction _direction) {
     if (offset) {
       if (cache) {
         cache->offsetTo(offset);
-      } else if (lseek(fd, offset, SEEK_CUR) == -1) {
+      } else if (seek(offset, SEEK_CUR) == -1) {
         std::ostringstream err;
         err << "Can' seek in file '" << name << "': " << strerror(errno);
         throw std::runtime_error(err.str());
@@ -267,7 +313,7 @@ void FileIO::unread() {
   if (direction == Direction::Forward) {
     offset = -1;
   }
-  if (lseek(fd, offset, SEEK_CUR) == -1) {
+  if (seek(offset, SEEK_CUR) == -1) {
     std::ostringstream err;
     err << "Can't unread from file '" << name
         << "': seek failed: " << strerror(errno);
@@ -279,3 +325,11 @@ void FileIO::unread() {
 int FileIO::fno() {
   return fd;
 }
+
+const char *FileIO::getName() const {
+  return name;
+}
+
+size_t FileIO::bytesRead() const {
+  return bytes_read;
+}
@@ -21,24 +21,29 @@ Mattext is distributed in the hope that it will be useful,
 
 #pragma once
 
+#include <sys/types.h>
 #include <memory>
 #include "direction.h"
+#include "symbol_input.h"
 
 class FileCache;
+struct IoCounters;
 
-static const size_t mbchar_size = 4;
-
-class FileIO {
+class FileIO : public SymbolInput {
  public:
-  enum class Status { Ok, End, WouldBlock };
-  FileIO(const char *name);
-  FileIO(int stdin_fd);
+  FileIO(const char *name, IoCounters &counters);
+  FileIO(int stdin_fd, IoCounters &counters);
   ~FileIO();
   void stop();
   void newPage(Direction direction);
-  Status read(wchar_t &symbol);
-  void unread();
+  Status read(wchar_t &symbol) override;
+  void unread() override;
+  // Reads raw bytes in forward direction, without cache
+  Status readChunk(char *buffer, size_t size, size_t &len);
   int fno();
+  const char *getName() const;
+  // Bytes read since new page was started
+  size_t bytesRead() const;
 
  private:
   int fd;
@@ -51,7 +56,10 @@ class FileIO {
   bool started = false;
   bool active = false;
   std::unique_ptr<FileCache> cache;
+  IoCounters &counters;
 
+  ssize_t readFd(char *byte_ptr);
+  off_t seek(off_t offset, int whence);
   Status readByteForward(char *byte_ptr);
   Status readForward(wchar_t &symbol);
   Status readByteBackward(char *byte_ptr);
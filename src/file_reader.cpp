@@ -23,37 +23,22 @@ Mattext is distributed in the hope that it will be useful,
 #include "config.h"
 #include "file_backward_reader.h"
 #include "file_forward_reader.h"
-#include "file_io.h"
 #include "file_reader_logic.h"
+#include "page_layout.h"
 #include "terminal.h"
 
 FileReader::FileReader(const Config &config, const Terminal &terminal)
     : terminal(terminal),
-      forward_reader(std::make_unique<ForwardReader>(lines, line_lens, config)),
-      backward_reader(
-          std::make_unique<BackwardReader>(lines, line_lens, config)) {}
+      layout(PageLayout::create(config)),
+      forward_reader(std::make_unique<ForwardReader>(page, config)),
+      backward_reader(std::make_unique<BackwardReader>(page, config)) {}
 
 FileReader::~FileReader() = default;
 
 void FileReader::newPage(Direction _direction) {
-  bool resized = false;
-  size_t line_len = terminal.getWidth();
-  size_t lines_num = terminal.getHeight();
-
-  if (lines.size() != lines_num) {
-    lines.resize(lines_num);
-    line_lens.resize(lines_num);
-    resized = true;
-  }
-  if (resized || (lines[0].size() != line_len + 2)) {
-    for (auto &line : lines) {
-      line.resize(line_len + 2);  //'\0' + possibly '\n' from next line
-    }
-  }
-
-  for (auto &line_len : line_lens) {
-    line_len = 0;
-  }
+  page.resize(terminal.getHeight(), terminal.getWidth());
+  page.clear();
+  grid_valid = false;
   if ((direction != _direction) && reader) {
     reader->directionChanged();
   }
@@ -66,7 +51,8 @@ void FileReader::newPage(Direction _direction) {
   reader->newPage();
 }
 
-bool FileReader::read(FileIO &f) {
+bool FileReader::read(SymbolInput &f) {
+  grid_valid = false;
   return reader->read(f);
 }
 
@@ -74,10 +60,33 @@ size_t FileReader::linesRead() const {
   return reader->linesRead();
 }
 
-wchar_t FileReader::get(size_t column, size_t row) const {
-  return reader->get(column, row);
+bool FileReader::linePartial() const {
+  const size_t row = linesRead();
+  return (direction == Direction::Forward) && (row < page.rows())
+         && page.lineLen(row);
+}
+
+size_t FileReader::lineLen(size_t row) const {
+  return page.lineLen(row);
 }
 
-std::wstring FileReader::getLine() const {
-  return reader->getLine();
+TextRow FileReader::getRow(size_t row) const {
+  return layout->getRow(page, reader->getShape(), row);
+}
+
+bool FileReader::getLine(TextRow &line) const {
+  size_t row;
+  if (!reader->nextLine(row)) {
+    return false;
+  }
+  line = layout->getLine(page, reader->getShape(), row);
+  return true;
+}
+
+const TextGrid &FileReader::getGrid() const {
+  if (!grid_valid) {
+    layout->fillGrid(page, reader->getShape(), grid);
+    grid_valid = true;
+  }
+  return grid;
 }
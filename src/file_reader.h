@@ -22,18 +22,30 @@ Mattext is distributed in the hope that it will be useful,
 #pragma once
 
 #include <memory>
-#include <vector>
 #include "direction.h"
+#include "page_buffer.h"
+#include "text_grid.h"
+#include "text_row.h"
 
 class Terminal;
 class Config;
 class FileReaderLogic;
-class FileIO;
+class PageLayout;
+class SymbolInput;
 
 class Text {
  public:
-  virtual wchar_t get(size_t column, size_t row) const = 0;
-  virtual std::wstring getLine() const = 0;
+  // Row of screen, with vertical and horizontal centering applied
+  virtual TextRow getRow(size_t row) const = 0;
+  // Sets line to the next line of page with its line end, returns false
+  // when all lines are returned
+  virtual bool getLine(TextRow &line) const = 0;
+  // Whole screen, it is laid out once per page and is valid until the
+  // next read
+  virtual const TextGrid &getGrid() const = 0;
+  wchar_t get(size_t column, size_t row) const {
+    return getGrid().get(column, row);
+  }
 };
 
 class FileReader : public Text {
@@ -41,15 +53,23 @@ class FileReader : public Text {
   FileReader(const Config &config, const Terminal &terminal);
   ~FileReader();
   void newPage(Direction direction);
-  bool read(FileIO &f);
+  bool read(SymbolInput &f);
   size_t linesRead() const;
-  wchar_t get(size_t column, size_t row) const override;
-  std::wstring getLine() const override;
+  // Returns true if input stopped in the middle of a line when reading
+  // forward. Page must not end there, newPage() would drop that part.
+  bool linePartial() const;
+  // Length of line of page read forward, without line end
+  size_t lineLen(size_t row) const;
+  TextRow getRow(size_t row) const override;
+  bool getLine(TextRow &line) const override;
+  const TextGrid &getGrid() const override;
 
  private:
   const Terminal &terminal;
-  std::vector<std::vector<wchar_t>> lines;
-  std::vector<size_t> line_lens;
+  PageBuffer page;
+  mutable TextGrid grid;
+  mutable bool grid_valid = false;
+  std::unique_ptr<PageLayout> layout;
   std::unique_ptr<FileReaderLogic> forward_reader;
   std::unique_ptr<FileReaderLogic> backward_reader;
   FileReaderLogic *reader = nullptr;
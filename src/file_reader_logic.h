@@ -21,17 +21,28 @@ Mattext is distributed in the hope that it will be useful,
 
 #pragma once
 
-#include <string>
+#include <stddef.h>
 
-class FileIO;
+class SymbolInput;
+
+// Part of page that is read and where it is shown when text is not
+// centered vertically
+struct PageShape {
+  size_t first_row = 0;
+  size_t lines = 0;
+  size_t top = 0;
+  size_t longest_line_len = 0;
+};
 
 class FileReaderLogic {
  public:
   virtual ~FileReaderLogic() = default;
   virtual void newPage() = 0;
   virtual void directionChanged() = 0;
-  virtual bool read(FileIO &f) = 0;
+  virtual bool read(SymbolInput &f) = 0;
   virtual size_t linesRead() const = 0;
-  virtual wchar_t get(size_t column, size_t row) const = 0;
-  virtual std::wstring getLine() const = 0;
+  virtual PageShape getShape() const = 0;
+  // Sets row to the next row of page for output, returns false when all
+  // rows are returned
+  virtual bool nextLine(size_t &row) const = 0;
 };
@@ -22,19 +22,32 @@ Mattext is distributed in the hope that it will be useful,
 #include "file_stream.h"
 #include <fcntl.h>
 #include <unistd.h>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
+#include "alloc_counter.h"
 #include "config.h"
 #include "file_io.h"
 #include "file_reader.h"
+#include "io_counters.h"
+#include "perf_counters.h"
+#include "stats.h"
 #include "terminal.h"
+#include "trace.h"
 
-FileStream::FileStream(const Config &config, const Terminal &terminal)
+FileStream::FileStream(const Config &config, const Terminal &terminal,
+                       Stats &stats)
     : config(config),
       terminal(terminal),
-      file_reader(std::make_unique<FileReader>(config, terminal)) {
+      file_reader(std::make_unique<FileReader>(config, terminal)),
+      read_time(stats.getHistogram("read")),
+      layout_time(stats.getHistogram("layout")),
+      layout_perf(stats.getPerfTotals("layout")),
+      trace(stats.getTrace()),
+      page_allocs(stats.getAllocTotals("page")),
+      counters(stats.getIoCounters()) {
   for (auto name : config.files) {
-    files.push_back(std::make_unique<FileIO>(name));
+    files.push_back(std::make_unique<FileIO>(name, counters));
   }
 
   if (!files.size()) {
@@ -43,7 +56,7 @@ FileStream::FileStream(const Config &config, const Terminal &terminal)
           "Please, specify input files or pipe something "
           "to program input");
     }
-    files.push_back(std::make_unique<FileIO>(terminal.stdinFd()));
+    files.push_back(std::make_unique<FileIO>(terminal.stdinFd(), counters));
   }
 
   current_file = files.begin();
@@ -53,20 +66,25 @@ FileStream::~FileStream() {
   stop();
 }
 
+static const char *directionName(Direction direction) {
+  return (direction == Direction::Forward) ? "forward" : "backward";
+}
+
 bool FileStream::nextFile() {
   auto prev_file = current_file;
+  TraceEvent event(trace, "file_switch");
+  event.arg("from", (**prev_file).getName());
+  event.arg("direction", directionName(direction));
 
   if (direction == Direction::Forward) {
     ++current_file;
     if (current_file != files.end()) {
-      (**prev_file).stop();
-      (**current_file).newPage(direction);
+      switchFile(prev_file);
       return true;
     }
   } else if (current_file != files.begin()) {
     --current_file;
-    (**prev_file).stop();
-    (**current_file).newPage(direction);
+    switchFile(prev_file);
     return true;
   }
   if (!config.infinite) {
@@ -81,23 +99,54 @@ bool FileStream::nextFile() {
     --current_file;
   }
 
+  switchFile(prev_file);
+  return true;
+}
+
+void FileStream::switchFile(FileList::iterator prev_file) {
   (**prev_file).stop();
   (**current_file).newPage(direction);
-  return true;
+  ++counters.file_switches;
+  counters.file_index = std::distance(files.begin(), current_file);
+}
+
+bool FileStream::readFile() {
+  FileIO &file = **current_file;
+  TraceEvent event(trace, "read");
+  const size_t bytes_read = file.bytesRead();
+  const uint64_t start = read_time ? Stats::now() : 0;
+
+  bool page_full;
+  {
+    PerfScope perf(layout_perf);
+    page_full = file_reader->read(file);
+  }
+  if (read_time) {
+    const uint64_t duration = Stats::now() - start;
+    read_time->record(duration);
+    page_layout_time += duration;
+  }
+
+  event.arg("file", file.getName());
+  event.arg("bytes", static_cast<int64_t>(file.bytesRead() - bytes_read));
+  event.arg("lines", file_reader->linesRead());
+  event.arg("direction", directionName(direction));
+  return page_full;
 }
 
 void FileStream::readCb(ev::io & /*w*/, int /*revents*/) {
-  if (!file_reader->read(**current_file)) {
-    if (file_reader->linesRead() >= block_lines) {
+  if (!readFile()) {
+    if ((file_reader->linesRead() >= block_lines)
+        && !file_reader->linePartial()) {
       io_watcher.stop();
-      on_read(*file_reader);
+      pageRead();
     }
     return;
   }
 
   io_watcher.stop();
   if (file_reader->linesRead()) {
-    on_read(*file_reader);
+    pageRead();
   } else if (nextFile()) {
     io_watcher.start((**current_file).fno(), ev::READ);
   } else if (on_end) {
@@ -105,12 +154,44 @@ void FileStream::readCb(ev::io & /*w*/, int /*revents*/) {
   }
 }
 
+void FileStream::pageRead() {
+  counters.lines_read += file_reader->linesRead();
+  if (direction == Direction::Forward) {
+    ++counters.pages_forward;
+  } else {
+    ++counters.pages_backward;
+  }
+  if (layout_time) {
+    layout_time->record(page_layout_time);
+  }
+  if (trace) {
+    TraceEvent event(trace, "page");
+    event.setStart(page_request_time);
+    event.arg("lines", file_reader->linesRead());
+    event.arg("direction", directionName(direction));
+  }
+  // Showing the page and starting its animation is part of the page path.
+  // on_read() may request the next page, which restarts page_allocs_start.
+  const uint64_t allocs_start = page_allocs_start;
+  on_read(*file_reader);
+  if (page_allocs) {
+    page_allocs->add(AllocCounter::count() - allocs_start);
+  }
+}
+
 void FileStream::stop() {
   io_watcher.stop();
 }
 
-void FileStream::read(std::function<void(const Text &text)> _on_read,
-                      std::function<void()> _on_end, Direction _direction) {
+void FileStream::onRead(std::function<void(const Text &text)> _on_read) {
+  on_read = _on_read;
+}
+
+void FileStream::onEnd(std::function<void()> _on_end) {
+  on_end = _on_end;
+}
+
+void FileStream::read(Direction _direction) {
   if (end_reached) {
     if (_direction == direction) {
       return;
@@ -121,9 +202,10 @@ void FileStream::read(std::function<void(const Text &text)> _on_read,
   }
 
   end_reached = false;
-  on_read = _on_read;
-  on_end = _on_end;
   direction = _direction;
+  page_layout_time = 0;
+  page_request_time = trace ? Stats::now() : 0;
+  page_allocs_start = page_allocs ? AllocCounter::count() : 0;
   block_lines =
       (config.block_lines < 0) ? terminal.getHeight() : config.block_lines;
 
@@ -22,6 +22,7 @@ Mattext is distributed in the hope that it will be useful,
 #pragma once
 
 #include <ev++.h>
+#include <stdint.h>
 #include <functional>
 #include <list>
 #include <memory>
@@ -32,15 +33,22 @@ class Config;
 class FileIO;
 class FileReader;
 class Text;
+class Stats;
+class Histogram;
+class Trace;
+struct IoCounters;
+struct PerfTotals;
+struct AllocTotals;
 
 class FileStream {
  public:
-  FileStream(const Config &config, const Terminal &terminal);
+  FileStream(const Config &config, const Terminal &terminal, Stats &stats);
   ~FileStream();
   void stop();
-  void read(std::function<void(const Text &text)> on_read,
-            std::function<void()> on_end,
-            Direction direction = Direction::Forward);
+  // Callbacks are set once, read() only starts reading of next page
+  void onRead(std::function<void(const Text &text)> on_read);
+  void onEnd(std::function<void()> on_end);
+  void read(Direction direction = Direction::Forward);
 
  private:
   const Config &config;
@@ -55,8 +63,20 @@ class FileStream {
   Direction direction;
   bool end_reached = false;
   size_t block_lines;
+  Histogram *read_time;
+  Histogram *layout_time;
+  PerfTotals *layout_perf;
+  uint64_t page_layout_time = 0;
+  Trace *trace;
+  uint64_t page_request_time = 0;
+  AllocTotals *page_allocs;
+  uint64_t page_allocs_start = 0;
+  IoCounters &counters;
 
   void readCb(ev::io &w, int revents);
+  bool readFile();
+  void pageRead();
   bool nextFile();
+  void switchFile(FileList::iterator prev_file);
   void switchDirection();
 };
@@ -0,0 +1,103 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "histogram.h"
+#include <algorithm>
+
+// Values up to 2^48 ns (about 78 hours) are distinguished
+static const uint64_t max_tracked = (UINT64_C(1) << 48) - 1;
+
+Histogram::Histogram(uint64_t deadline)
+    : buckets(getBucket(max_tracked) + 1), deadline(deadline) {}
+
+size_t Histogram::getBucket(uint64_t value) {
+  const uint64_t sub_buckets = 1 << sub_bits;
+  value = std::min(value, max_tracked);
+  if (value < sub_buckets) {
+    return value;
+  }
+
+  const int shift = (63 - __builtin_clzll(value)) - sub_bits;
+  return (shift * sub_buckets) + (value >> shift);
+}
+
+uint64_t Histogram::getBucketMax(size_t bucket) {
+  const uint64_t sub_buckets = 1 << sub_bits;
+  if (bucket < sub_buckets * 2) {
+    return bucket;
+  }
+
+  const int shift = (bucket / sub_buckets) - 1;
+  const uint64_t sub_bucket = (bucket % sub_buckets) + sub_buckets;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+  std::lock_guard<std::mutex> lock(mutex);
+  ++buckets[getBucket(value)];
+  ++values_num;
+  values_sum += value;
+  if (deadline && (value > deadline)) {
+    ++missed_num;
+  }
+  if (value > max_value) {
+    max_value = value;
+  }
+}
+
+size_t Histogram::count() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return values_num;
+}
+
+size_t Histogram::missed() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return missed_num;
+}
+
+uint64_t Histogram::max() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return max_value;
+}
+
+uint64_t Histogram::sum() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return values_sum;
+}
+
+uint64_t Histogram::percentile(double p) const {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (!values_num) {
+    return 0;
+  }
+
+  const size_t rank =
+      std::max<size_t>(1, static_cast<size_t>(p * values_num + 0.5));
+  size_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return std::min(getBucketMax(i), max_value);
+    }
+  }
+  return max_value;
+}
@@ -0,0 +1,57 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+
+// Histogram of durations in nanoseconds with logarithmic buckets, every
+// power of two range is split into 32 linear sub buckets, so values are kept
+// with about 3% precision. Plain mode records values on its own threads
+// while metrics are written by event loop thread, so access is locked.
+class Histogram {
+ public:
+  // Values above deadline are counted as missed, zero disables counting
+  Histogram(uint64_t deadline = 0);
+  void record(uint64_t value);
+  size_t count() const;
+  size_t missed() const;
+  uint64_t max() const;
+  uint64_t sum() const;
+  // Returns value not exceeded by part p (0..1) of recorded values
+  uint64_t percentile(double p) const;
+
+ private:
+  static const int sub_bits = 5;
+  mutable std::mutex mutex;
+  std::vector<uint64_t> buckets;
+  uint64_t deadline;
+  size_t values_num = 0;
+  size_t missed_num = 0;
+  uint64_t max_value = 0;
+  uint64_t values_sum = 0;
+
+  static size_t getBucket(uint64_t value);
+  static uint64_t getBucketMax(size_t bucket);
+};
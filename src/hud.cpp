@@ -0,0 +1,166 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "hud.h"
+#include <wchar.h>
+#include <algorithm>
+#include "config.h"
+#include "file_reader.h"
+#include "io_counters.h"
+#include "stats.h"
+#include "terminal.h"
+
+static const double update_interval = 0.25;
+
+Hud::Hud(const Config &config, const IoCounters &io_counters)
+    : config(config), io_counters(io_counters) {
+  timer_watcher.set<Hud, &Hud::update>(this);
+}
+
+void Hud::toggle(const Terminal &_terminal, const Text *text) {
+  terminal = &_terminal;
+  if (visible) {
+    erase(text);
+    visible = false;
+    timer_watcher.stop();
+  } else {
+    visible = true;
+    lines.clear();
+    resetWindow();
+    timer_watcher.start(update_interval, update_interval);
+  }
+  terminal->showOverlay();
+}
+
+bool Hud::isVisible() const {
+  return visible;
+}
+
+void Hud::frameShown() {
+  ++frames;
+  if (visible) {
+    draw();
+  }
+}
+
+void Hud::tickDone(uint64_t duration) {
+  ++ticks;
+  ticks_time += duration;
+  tick_max_time = std::max(tick_max_time, duration);
+}
+
+void Hud::resetWindow() {
+  window_start = Stats::now();
+  frames = 0;
+  ticks = 0;
+  ticks_time = 0;
+  tick_max_time = 0;
+  bytes_read = io_counters.bytes_read;
+  Stats::readBytesWritten(bytes_written);
+}
+
+void Hud::update(ev::timer & /*w*/, int /*revents*/) {
+  const double seconds = (Stats::now() - window_start) / 1e9;
+  const uint64_t prev_bytes_written = bytes_written;
+  const bool has_bytes_written = Stats::readBytesWritten(bytes_written);
+  const uint64_t written = bytes_written - prev_bytes_written;
+  const uint64_t hits = io_counters.cache_hits;
+  const uint64_t requests = hits + io_counters.cache_misses;
+  wchar_t line[64];
+  lines.clear();
+
+  swprintf(line, 64, L"fps   %7.1f", frames / seconds);
+  lines.push_back(line);
+  if (ticks) {
+    swprintf(line, 64, L"tick  %7.2f/%.2f of %d ms",
+             ticks_time / 1e6 / ticks, tick_max_time / 1e6, config.delay);
+  } else {
+    swprintf(line, 64, L"tick  %7s", "-");
+  }
+  lines.push_back(line);
+  if (!has_bytes_written) {
+    swprintf(line, 64, L"out   %7s", "n/a");
+  } else if (frames) {
+    swprintf(line, 64, L"out   %7.0f B/frame",
+             static_cast<double>(written) / frames);
+  } else {
+    swprintf(line, 64, L"out   %7.0f B/s", written / seconds);
+  }
+  lines.push_back(line);
+  swprintf(line, 64, L"in    %7.1f KB/s",
+           (io_counters.bytes_read - bytes_read) / seconds / 1024);
+  lines.push_back(line);
+  if (requests) {
+    swprintf(line, 64, L"cache %6.1f%% hit", hits * 100. / requests);
+  } else {
+    swprintf(line, 64, L"cache %7s", "n/a");
+  }
+  lines.push_back(line);
+
+  size_t width = 0;
+  for (const auto &str : lines) {
+    width = std::max(width, str.size());
+  }
+  // Box only grows, so longer old text does not stay on screen
+  box_width = std::max(box_width, width + 2);
+
+  resetWindow();
+  // Frames of animation are not counted when only overlay changes
+  draw();
+  terminal->showOverlay();
+}
+
+bool Hud::fits() const {
+  return (box_width <= terminal->getWidth())
+         && (lines.size() <= terminal->getHeight());
+}
+
+void Hud::draw() const {
+  if (!fits()) {
+    return;
+  }
+  const int start_column = terminal->getWidth() - box_width;
+  const int fg = ColorWhite;
+  const int bg = ColorBlue;
+
+  for (size_t row = 0; row < lines.size(); ++row) {
+    const std::wstring &line = lines[row];
+    const size_t len = std::min(line.size(), box_width - 1);
+    terminal->set(start_column, row, L' ', true, fg, bg);
+    terminal->setRow(start_column + 1, row, line.data(), len, true, fg, bg);
+    terminal->fillRect(start_column + 1 + len, row, box_width - 1 - len, 1,
+                       L' ', true, fg, bg);
+  }
+}
+
+void Hud::erase(const Text *text) const {
+  if (!fits()) {
+    return;
+  }
+  const int start_column = terminal->getWidth() - box_width;
+
+  if (text) {
+    terminal->blitText(text->getGrid(), start_column, 0, box_width,
+                       lines.size());
+  } else {
+    terminal->fillRect(start_column, 0, box_width, lines.size(), L' ');
+  }
+}
@@ -0,0 +1,69 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <ev++.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class Config;
+class Terminal;
+class Text;
+struct IoCounters;
+
+// Overlay in the top right corner of terminal with frame rate, tick time,
+// output and input rates. Numbers are recalculated a few times per second,
+// between updates overlay is only redrawn on top of animation frames.
+class Hud {
+ public:
+  Hud(const Config &config, const IoCounters &io_counters);
+  // Text of current page is shown again under hidden overlay, it may be null
+  // before first page is read
+  void toggle(const Terminal &terminal, const Text *text);
+  bool isVisible() const;
+  // Is called by terminal before screen is updated
+  void frameShown();
+  void tickDone(uint64_t duration);
+
+ private:
+  const Config &config;
+  const IoCounters &io_counters;
+  const Terminal *terminal = nullptr;
+  bool visible = false;
+  ev::timer timer_watcher;
+  std::vector<std::wstring> lines;
+  size_t box_width = 0;
+  uint64_t window_start = 0;
+  uint64_t frames = 0;
+  uint64_t ticks = 0;
+  uint64_t ticks_time = 0;
+  uint64_t tick_max_time = 0;
+  uint64_t bytes_read = 0;
+  uint64_t bytes_written = 0;
+
+  void update(ev::timer &w, int revents);
+  void draw() const;
+  void erase(const Text *text) const;
+  bool fits() const;
+  void resetWindow();
+};
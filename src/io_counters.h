@@ -0,0 +1,69 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+// Counter changed by one thread at a time and read by any thread. Stage
+// threads of plain mode update counters while event loop thread reads them
+// for metrics and SIGUSR1 dumps. Relaxed load and store are plain moves, so
+// counting costs the same as with uint64_t.
+class IoCounter {
+ public:
+  IoCounter &operator++() {
+    return *this += 1;
+  }
+  IoCounter &operator+=(uint64_t delta) {
+    value.store(value.load(std::memory_order_relaxed) + delta,
+                std::memory_order_relaxed);
+    return *this;
+  }
+  IoCounter &operator=(uint64_t _value) {
+    value.store(_value, std::memory_order_relaxed);
+    return *this;
+  }
+  operator uint64_t() const {
+    return value.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<uint64_t> value{0};
+};
+
+// Input activity counters, they are always collected, as incrementing them
+// costs much less than reading data
+struct IoCounters {
+  IoCounter syscalls;
+  IoCounter bytes_read;
+  IoCounter seeks;
+  IoCounter would_block;
+  IoCounter cache_hits;
+  IoCounter cache_misses;
+  IoCounter cache_evicted_bytes;
+  IoCounter pages_forward;
+  IoCounter pages_backward;
+  IoCounter file_switches;
+  IoCounter lines_read;
+  // Position of current file in list of files
+  IoCounter file_index;
+};
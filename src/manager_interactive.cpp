@@ -29,20 +29,31 @@ Mattext is distributed in the hope that it will be useful,
 #include "config.h"
 #include "direction.h"
 #include "file_stream.h"
+#include "hud.h"
+#include "stats.h"
 #include "terminal.h"
 
 ManagerInteractive::ManagerInteractive(const Config &config,
                                        FileStream &file_stream,
-                                       const Terminal &terminal)
+                                       const Terminal &terminal,
+                                       Stats &stats)
     : config(config),
       file_stream(file_stream),
       terminal(terminal),
-      animations(std::make_unique<AnimationStore>(config, terminal)) {
+      animations(std::make_unique<AnimationStore>(config, terminal, stats)),
+      hud(stats.getHud()) {
   terminal.onKeyPress([this](int cmd) { this->inputCb(cmd); });
+  if (config.hud) {
+    hud.toggle(terminal, nullptr);
+  }
 
   animation_next = animations->get(config.animation_next);
   animation_prev = animations->get(config.animation_prev);
   current_animation = animation_next;
+  for (auto animation : {animation_next, animation_prev}) {
+    animation->onStop([this]() { this->checkPending(); });
+  }
+  file_stream.onRead([this](const Text &text) { this->showPage(text); });
 
   getNextPage();
 }
@@ -73,12 +84,19 @@ void ManagerInteractive::inputCb(int cmd) {
     case KEY_UP:
       getPrevPage();
       break;
+    case 'h':
+    case 'H':
+      hud.toggle(terminal, current_text);
+      break;
     default:
       break;
   }
 }
 
 void ManagerInteractive::checkPending() {
+  if (on_page_shown) {
+    on_page_shown();
+  }
   auto action = pending_action;
   pending_action = Action::None;
   if ((action == Action::Next) || config.noninteract) {
@@ -94,11 +112,7 @@ void ManagerInteractive::getNextPage() {
     return;
   }
   current_animation = animation_next;
-  file_stream.read(
-      [this](const Text &text) {
-        this->current_animation->play(text, [this]() { this->checkPending(); });
-      },
-      nullptr);
+  file_stream.read(Direction::Forward);
 }
 
 void ManagerInteractive::getPrevPage() {
@@ -107,11 +121,19 @@ void ManagerInteractive::getPrevPage() {
     return;
   }
   current_animation = animation_prev;
-  file_stream.read(
-      [this](const Text &text) {
-        this->current_animation->play(text, [this]() { this->checkPending(); });
-      },
-      nullptr, Direction::Backward);
+  file_stream.read(Direction::Backward);
+}
+
+void ManagerInteractive::showPage(const Text &text) {
+  current_text = &text;
+  current_animation->play(text);
+  if (!current_animation->isPlaying() && on_page_shown) {
+    on_page_shown();
+  }
+}
+
+void ManagerInteractive::onPageShown(std::function<void()> _on_page_shown) {
+  on_page_shown = _on_page_shown;
 }
 
 void ManagerInteractive::quit() {
@@ -21,6 +21,7 @@ Mattext is distributed in the hope that it will be useful,
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include "manager.h"
 
@@ -29,13 +30,18 @@ class Terminal;
 class FileStream;
 class Animation;
 class AnimationStore;
+class Text;
+class Stats;
+class Hud;
 
 class ManagerInteractive : public Manager {
  public:
   ManagerInteractive(const Config &config, FileStream &file_stream,
-                     const Terminal &terminal);
+                     const Terminal &terminal, Stats &stats);
   ~ManagerInteractive();
   void checkPending();
+  // Is called when page is fully shown
+  void onPageShown(std::function<void()> on_page_shown);
 
  private:
   const Config &config;
@@ -45,11 +51,15 @@ class ManagerInteractive : public Manager {
   Animation *animation_next;
   Animation *animation_prev;
   Animation *current_animation;
+  const Text *current_text = nullptr;
   enum class Action { None, Next, Prev };
   Action pending_action = Action::None;
+  std::function<void()> on_page_shown;
+  Hud &hud;
 
   void getNextPage();
   void getPrevPage();
   void inputCb(int cmd);
+  void showPage(const Text &text);
   void quit();
 };
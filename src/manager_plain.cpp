@@ -21,38 +21,43 @@ Mattext is distributed in the hope that it will be useful,
 
 #include "manager_plain.h"
 #include <ev++.h>
-#include <string.h>
-#include <wchar.h>
-#include <sstream>
-#include <stdexcept>
+#include <unistd.h>
 #include "file_reader.h"
 #include "file_stream.h"
 
-ManagerPlain::ManagerPlain(FileStream &file_stream) : file_stream(file_stream) {
+ManagerPlain::ManagerPlain(FileStream &file_stream)
+    : file_stream(file_stream), output(STDOUT_FILENO) {
+  file_stream.onRead([this](const Text &text) { this->print(text); });
+  file_stream.onEnd([this]() { this->quit(); });
+  idle_watcher.set<ManagerPlain, &ManagerPlain::idleCb>(this);
   read();
 }
 
 ManagerPlain::~ManagerPlain() = default;
 
 void ManagerPlain::read() {
-  file_stream.read(
-      [this](const Text &text) {
-        while (true) {
-          auto line = text.getLine();
-          if (!line.length()) {
-            this->read();
-            return;
-          }
-          if (fputws(line.c_str(), stdout) == -1) {
-            std::ostringstream err;
-            err << "Can't write to stdout: " << strerror(errno);
-            throw std::runtime_error(err.str());
-          }
-        }
-      },
-      [this]() { this->quit(); });
+  file_stream.read();
+}
+
+void ManagerPlain::print(const Text &text) {
+  while (text.getLine(line)) {
+    output.write(line);
+  }
+  // Idle watcher is called only when input has no data, so text from pipe
+  // is shown as soon as it is read, and files are written in big chunks
+  if (!idle_watcher.is_active()) {
+    idle_watcher.start();
+  }
+  read();
+}
+
+void ManagerPlain::idleCb(ev::idle & /*w*/, int /*revents*/) {
+  idle_watcher.stop();
+  output.flush();
 }
 
 void ManagerPlain::quit() {
+  idle_watcher.stop();
+  output.flush();
   ev::get_default_loop().break_loop(ev::ALL);
 }
@@ -21,9 +21,13 @@ Mattext is distributed in the hope that it will be useful,
 
 #pragma once
 
+#include <ev++.h>
 #include "manager.h"
+#include "output_writer.h"
+#include "text_row.h"
 
 class FileStream;
+class Text;
 
 class ManagerPlain : public Manager {
  public:
@@ -34,4 +38,10 @@ class ManagerPlain : public Manager {
 
  private:
   FileStream &file_stream;
+  TextRow line;
+  OutputWriter output;
+  ev::idle idle_watcher;
+
+  void print(const Text &text);
+  void idleCb(ev::idle &w, int revents);
 };
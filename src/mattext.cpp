@@ -21,32 +21,83 @@ Mattext is distributed in the hope that it will be useful,
 
 #include <ev++.h>
 #include <locale.h>
-#include <stdlib.h>
 #include <exception>
 #include <memory>
+#include "bench.h"
 #include "config.h"
+#include "event_loop_thread.h"
 #include "file_stream.h"
 #include "manager_interactive.h"
 #include "manager_plain.h"
-#include "terminal.h"
+#include "metrics.h"
+#include "plain_pipeline.h"
+#include "plain_reflow.h"
+#include "stats.h"
+#include "terminal_curses.h"
+#include "terminal_headless.h"
+
+static void runBench(const Config &config, Stats &stats) {
+  HeadlessTerminal terminal(config, stats);
+  FileStream file_stream(config, terminal, stats);
+  ManagerInteractive manager(config, file_stream, terminal, stats);
+  Bench bench(config, terminal, manager);
+  MetricsExporter metrics(config, stats);
+
+  stats.watchCounters(false);
+  ev_run(EV_DEFAULT, 0);
+  bench.report(stdout);
+}
+
+static void run(const Config &config, Stats &stats) {
+  CursesTerminal terminal(config, stats);
+  if (!terminal.stdoutIsTty() && PlainReflow::isSupported(config)) {
+    PlainReflow reflow(config, terminal, stats);
+    MetricsExporter metrics(config, stats);
+    stats.watchCounters(false);
+    EventLoopThread loop;
+    reflow.run();
+    return;
+  }
+  if (!terminal.stdoutIsTty() && PlainPipeline::isSupported(config)) {
+    PlainPipeline pipeline(config, terminal, stats);
+    MetricsExporter metrics(config, stats);
+    stats.watchCounters(false);
+    EventLoopThread loop;
+    pipeline.run();
+    return;
+  }
+  FileStream file_stream(config, terminal, stats);
+  std::unique_ptr<Manager> manager;
+  if (terminal.stdoutIsTty()) {
+    manager = std::make_unique<ManagerInteractive>(config, file_stream,
+                                                   terminal, stats);
+  } else {
+    manager = std::make_unique<ManagerPlain>(file_stream);
+  }
+  MetricsExporter metrics(config, stats);
+
+  // Screen of interactive mode would be corrupted by counters on stderr
+  stats.watchCounters(terminal.stdoutIsTty());
+  ev_run(EV_DEFAULT, 0);
+}
 
 int main(int argc, char *argv[]) {
-  srand(time(nullptr));
   setlocale(LC_CTYPE, "");
 
   try {
     Config config(argc, argv);
-    Terminal terminal(config);
-    FileStream file_stream(config, terminal);
-    std::unique_ptr<Manager> manager;
-    if (terminal.stdoutIsTty()) {
-      manager =
-          std::make_unique<ManagerInteractive>(config, file_stream, terminal);
+    Stats stats(config);
+    if (config.bench_pages) {
+      runBench(config, stats);
     } else {
-      manager = std::make_unique<ManagerPlain>(file_stream);
+      // Terminal is restored before report is printed
+      run(config, stats);
     }
-
-    ev_run(EV_DEFAULT, 0);
+    stats.report();
+    if (config.counters) {
+      stats.dumpCounters();
+    }
+    stats.reportCountersFile();
   } catch (std::exception &e) {
     fprintf(stderr, "%s\n", e.what());
     return 1;
@@ -0,0 +1,136 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "metrics.h"
+#include <stdint.h>
+#include <string>
+#include "config.h"
+#include "histogram.h"
+#include "io_counters.h"
+#include "stats.h"
+
+static const double quantiles[]{0.5, 0.9, 0.99};
+
+MetricsExporter::MetricsExporter(const Config &config, const Stats &stats)
+    : config(config), stats(stats) {
+  if (config.metrics_file.empty()) {
+    return;
+  }
+  timer_watcher.set<MetricsExporter, &MetricsExporter::timerCb>(this);
+  timer_watcher.start(config.metrics_interval, config.metrics_interval);
+}
+
+MetricsExporter::~MetricsExporter() {
+  if (config.metrics_file.empty()) {
+    return;
+  }
+  // Final values of counters are not lost
+  try {
+    write();
+  } catch (std::exception &e) {
+    fprintf(stderr, "%s\n", e.what());
+  }
+}
+
+void MetricsExporter::timerCb(ev::timer & /*w*/, int /*revents*/) {
+  write();
+}
+
+void MetricsExporter::write() const {
+  Stats::writeFile(config.metrics_file,
+                   [this](FILE *out) { this->write(out); });
+}
+
+static void writeHeader(FILE *out, const char *name, const char *type,
+                        const char *help) {
+  fprintf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static void writeSummary(FILE *out, const char *name, const char *label,
+                         const std::string &value,
+                         const Histogram &histogram) {
+  for (double quantile : quantiles) {
+    fprintf(out, "%s{%s=\"%s\",quantile=\"%g\"} %.9f\n", name, label,
+            value.c_str(), quantile, histogram.percentile(quantile) / 1e9);
+  }
+  fprintf(out, "%s_sum{%s=\"%s\"} %.9f\n", name, label, value.c_str(),
+          histogram.sum() / 1e9);
+  fprintf(out, "%s_count{%s=\"%s\"} %zu\n", name, label, value.c_str(),
+          histogram.count());
+}
+
+void MetricsExporter::write(FILE *out) const {
+  const std::string tick_prefix = "tick.";
+  const auto &histograms = stats.getHistograms();
+  const IoCounters &counters = stats.getIoCounters();
+
+  writeHeader(out, "mattext_frame_seconds", "summary",
+              "Time spent on rendering animation frames.");
+  for (const auto &item : histograms) {
+    if (!item.first.compare(0, tick_prefix.size(), tick_prefix)) {
+      writeSummary(out, "mattext_frame_seconds", "animation",
+                   item.first.substr(tick_prefix.size()), item.second);
+    }
+  }
+  writeHeader(out, "mattext_dropped_frames_total", "counter",
+              "Frames rendered longer than delay between frames.");
+  for (const auto &item : histograms) {
+    if (!item.first.compare(0, tick_prefix.size(), tick_prefix)) {
+      fprintf(out, "mattext_dropped_frames_total{animation=\"%s\"} %zu\n",
+              item.first.substr(tick_prefix.size()).c_str(),
+              item.second.missed());
+    }
+  }
+  writeHeader(out, "mattext_stage_seconds", "summary",
+              "Time spent on screen updates, reads and page layout.");
+  for (const auto &item : histograms) {
+    if (item.first.compare(0, tick_prefix.size(), tick_prefix)) {
+      writeSummary(out, "mattext_stage_seconds", "stage", item.first,
+                   item.second);
+    }
+  }
+
+  uint64_t value = 0;
+  if (Stats::readBytesWritten(value)) {
+    writeHeader(out, "mattext_rendered_bytes_total", "counter",
+                "Bytes written to terminal and files.");
+    fprintf(out, "mattext_rendered_bytes_total %llu\n",
+            static_cast<unsigned long long>(value));
+  }
+  writeHeader(out, "mattext_input_bytes_total", "counter",
+              "Bytes read from input files.");
+  fprintf(out, "mattext_input_bytes_total %llu\n",
+          static_cast<unsigned long long>(counters.bytes_read));
+  writeHeader(out, "mattext_input_lines_total", "counter",
+              "Lines of input shown in pages.");
+  fprintf(out, "mattext_input_lines_total %llu\n",
+          static_cast<unsigned long long>(counters.lines_read));
+  writeHeader(out, "mattext_current_file_index", "gauge",
+              "Position of shown file in list of files.");
+  fprintf(out, "mattext_current_file_index %llu\n",
+          static_cast<unsigned long long>(counters.file_index));
+  if (Stats::readResidentMemory(value)) {
+    writeHeader(out, "mattext_resident_memory_bytes", "gauge",
+                "Resident set size of process.");
+    fprintf(out, "mattext_resident_memory_bytes %llu\n",
+            static_cast<unsigned long long>(value));
+  }
+}
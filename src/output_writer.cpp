@@ -0,0 +1,120 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "output_writer.h"
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+OutputWriter::OutputWriter(int fd, size_t buffer_size)
+    : fd(fd), buffer(buffer_size) {}
+
+void OutputWriter::write(const wchar_t *str, size_t len) {
+  const size_t symbol_max_size = encoder.symbolMaxSize();
+
+  while (len) {
+    if (buffer.size() - used < symbol_max_size) {
+      flush();
+    }
+    // Number of symbols that fit into free space in any encoding
+    const size_t chunk =
+        std::min(len, (buffer.size() - used) / symbol_max_size);
+    used = encoder.encode(str, chunk, buffer.data() + used) - buffer.data();
+    str += chunk;
+    len -= chunk;
+  }
+}
+
+void OutputWriter::write(const TextRow &row) {
+  const size_t symbol_max_size = encoder.symbolMaxSize();
+  size_t id = 0;
+
+  writeSpaces(row.padding);
+  while (id < row.size) {
+    if (buffer.size() - used < symbol_max_size) {
+      flush();
+    }
+    const size_t end =
+        std::min(row.size, id + (buffer.size() - used) / symbol_max_size);
+    char *out = buffer.data() + used;
+    for (; id < end; ++id) {
+      out = encoder.encode(row.symbol(id), out);
+    }
+    used = out - buffer.data();
+  }
+}
+
+void OutputWriter::writeSpaces(size_t count) {
+  while (count) {
+    if (used == buffer.size()) {
+      flush();
+    }
+    const size_t chunk = std::min(count, buffer.size() - used);
+    memset(buffer.data() + used, ' ', chunk);
+    used += chunk;
+    count -= chunk;
+  }
+}
+
+void OutputWriter::writeBytes(const char *data, size_t len) {
+  if (len > buffer.size() - used) {
+    flush();
+    if (len >= buffer.size()) {
+      writeFd(data, len);
+      return;
+    }
+  }
+  memcpy(buffer.data() + used, data, len);
+  used += len;
+}
+
+void OutputWriter::flush() {
+  writeFd(buffer.data(), used);
+  used = 0;
+}
+
+void OutputWriter::writeFd(const char *data, size_t len) {
+  size_t written = 0;
+
+  while (written < len) {
+    const ssize_t res = ::write(fd, data + written, len - written);
+    if (res >= 0) {
+      written += res;
+      continue;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+      pollfd pfd{fd, POLLOUT, 0};
+      if ((poll(&pfd, 1, -1) >= 0) || (errno == EINTR)) {
+        continue;
+      }
+    }
+    std::ostringstream err;
+    err << "Can't write to stdout: " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+}
@@ -0,0 +1,51 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <wchar.h>
+#include <vector>
+#include "text_encoder.h"
+#include "text_row.h"
+
+// Encodes text into a reusable buffer and writes it to file descriptor in
+// big chunks
+class OutputWriter {
+ public:
+  OutputWriter(int fd, size_t buffer_size = 1 << 20);
+  void write(const wchar_t *str, size_t len);
+  // Writes padding and symbols of row
+  void write(const TextRow &row);
+  void writeSpaces(size_t count);
+  // Writes text that is already encoded, big blocks bypass the buffer
+  void writeBytes(const char *data, size_t len);
+  // Writes buffered data, waits for descriptor if it is non-blocking
+  void flush();
+
+ private:
+  int fd;
+  std::vector<char> buffer;
+  size_t used = 0;
+  TextEncoder encoder;
+
+  void writeFd(const char *data, size_t len);
+};
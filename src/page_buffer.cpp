@@ -0,0 +1,88 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "page_buffer.h"
+#include <algorithm>
+
+static const size_t cache_line_size = 64;
+static const size_t cache_line_cells =
+    cache_line_size / sizeof(PageBuffer::Cell);
+
+void PageBuffer::resize(size_t _rows_num, size_t width) {
+  if ((rows_num == _rows_num) && (line_width == width)) {
+    return;
+  }
+  rows_num = _rows_num;
+  line_width = width;
+  //'\0' + possibly '\n' from next line
+  stride = (width + 2 + cache_line_cells - 1) / cache_line_cells
+           * cache_line_cells;
+  symbols.assign(rows_num * stride + cache_line_cells, 0);
+  line_lens.assign(rows_num, 0);
+  overflow.resize(rows_num);
+
+  const auto address = reinterpret_cast<uintptr_t>(symbols.data());
+  const size_t offset = (cache_line_size - address % cache_line_size)
+                        % cache_line_size / sizeof(Cell);
+  first_row = symbols.data() + offset;
+}
+
+void PageBuffer::set(size_t row, size_t column, const wchar_t *symbols,
+                     size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    set(row, column + i, symbols[i]);
+  }
+}
+
+size_t PageBuffer::textLen(size_t row) const {
+  const Cell *row_cells = cells(row);
+  return std::find(row_cells, row_cells + stride, 0) - row_cells;
+}
+
+void PageBuffer::clear() {
+  std::fill(line_lens.begin(), line_lens.end(), 0);
+  for (auto &row_overflow : overflow) {
+    row_overflow.clear();
+  }
+}
+
+wchar_t PageBuffer::getOverflow(size_t row, size_t column, Cell cell) const {
+  const auto &row_overflow = overflow[row];
+  const size_t index = cell - escape;
+  if (index < max_direct_index) {
+    return row_overflow[index].symbol;
+  }
+
+  // Symbols of row are added from left to right
+  auto it = std::upper_bound(
+      row_overflow.begin() + max_direct_index, row_overflow.end(), column,
+      [](size_t col, const Overflow &item) { return col < item.column; });
+  return (--it)->symbol;
+}
+
+void PageBuffer::setOverflow(size_t row, size_t column, wchar_t symbol) {
+  auto &row_overflow = overflow[row];
+  const size_t index = (row_overflow.size() < max_direct_index)
+                           ? row_overflow.size()
+                           : max_direct_index;
+  row_overflow.push_back({column, symbol});
+  rowCells(row)[column] = escape + index;
+}
@@ -0,0 +1,108 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+#include <vector>
+
+// Page text in one block of memory, a symbol takes 16 bits. Symbols out of
+// the basic multilingual plane are kept in overflow table of their row,
+// their cells keep index in the table in the range of UTF-16 surrogates,
+// which are never decoded from input. Rows start at cache line boundaries
+// and keep width symbols, '\n' and '\0'. Lengths of lines are kept
+// separately.
+class PageBuffer {
+ public:
+  using Cell = uint16_t;
+
+  // Memory is allocated again only when size changes
+  void resize(size_t rows_num, size_t width);
+  size_t rows() const {
+    return rows_num;
+  }
+  // Longest line without line end
+  size_t width() const {
+    return line_width;
+  }
+  wchar_t get(size_t row, size_t column) const {
+    return get(cells(row), row, column);
+  }
+  // The same for cells of row that are already found
+  wchar_t get(const Cell *row_cells, size_t row, size_t column) const {
+    const Cell cell = row_cells[column];
+    if ((cell & escape_mask) != escape) {
+      return cell;
+    }
+    return getOverflow(row, column, cell);
+  }
+  const Cell *cells(size_t row) const {
+    return first_row + row * stride;
+  }
+  void set(size_t row, size_t column, wchar_t symbol) {
+    const uint32_t code = static_cast<uint32_t>(symbol);
+    if ((code > 0xffff) || ((code & escape_mask) == escape)) {
+      setOverflow(row, column, symbol);
+      return;
+    }
+    rowCells(row)[column] = code;
+  }
+  void set(size_t row, size_t column, const wchar_t *symbols, size_t len);
+  size_t &lineLen(size_t row) {
+    return line_lens[row];
+  }
+  size_t lineLen(size_t row) const {
+    return line_lens[row];
+  }
+  // Number of symbols before '\0'
+  size_t textLen(size_t row) const;
+  // Clears lengths of lines and overflow tables for new page
+  void clear();
+
+ private:
+  struct Overflow {
+    size_t column;
+    wchar_t symbol;
+  };
+
+  static const Cell escape = 0xd800;
+  static const Cell escape_mask = 0xf800;
+  // Cells of the rest of symbols in long rows keep the last index, such
+  // symbols are searched by column
+  static const size_t max_direct_index = 0x7ff;
+
+  std::vector<Cell> symbols;
+  std::vector<size_t> line_lens;
+  std::vector<std::vector<Overflow>> overflow;
+  Cell *first_row = nullptr;
+  size_t rows_num = 0;
+  size_t line_width = 0;
+  // Distance between rows in cells
+  size_t stride = 0;
+
+  Cell *rowCells(size_t row) {
+    return first_row + row * stride;
+  }
+  wchar_t getOverflow(size_t row, size_t column, Cell cell) const;
+  void setOverflow(size_t row, size_t column, wchar_t symbol);
+};
@@ -0,0 +1,48 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "page_layout.h"
+#include "config.h"
+
+std::unique_ptr<PageLayout> PageLayout::create(const Config &config) {
+  const int flags = (config.center_vert ? 4 : 0)
+                    | (config.center_horiz ? 2 : 0)
+                    | (config.center_horiz_longest ? 1 : 0);
+
+  switch (flags) {
+    case 0:
+      return std::make_unique<CenteredLayout<false, false, false>>();
+    case 1:
+      return std::make_unique<CenteredLayout<false, false, true>>();
+    case 2:
+      return std::make_unique<CenteredLayout<false, true, false>>();
+    case 3:
+      return std::make_unique<CenteredLayout<false, true, true>>();
+    case 4:
+      return std::make_unique<CenteredLayout<true, false, false>>();
+    case 5:
+      return std::make_unique<CenteredLayout<true, false, true>>();
+    case 6:
+      return std::make_unique<CenteredLayout<true, true, false>>();
+    default:
+      return std::make_unique<CenteredLayout<true, true, true>>();
+  }
+}
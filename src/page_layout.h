@@ -0,0 +1,107 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+#include <memory>
+#include "file_reader_logic.h"
+#include "page_buffer.h"
+#include "text_grid.h"
+#include "text_row.h"
+
+class Config;
+
+// Places lines of page on screen. Centering options never change while
+// program runs, so layout is instantiated for every combination of them
+// and is chosen once, and rows and cells are laid out without testing
+// options.
+class PageLayout {
+ public:
+  virtual ~PageLayout() = default;
+  static std::unique_ptr<PageLayout> create(const Config &config);
+  // Row of screen
+  virtual TextRow getRow(const PageBuffer &page, const PageShape &shape,
+                         size_t row) const = 0;
+  // Row of page for plain output, with its line end
+  virtual TextRow getLine(const PageBuffer &page, const PageShape &shape,
+                          size_t row) const = 0;
+  virtual void fillGrid(const PageBuffer &page, const PageShape &shape,
+                        TextGrid &grid) const = 0;
+};
+
+template <bool center_vert, bool center_horiz, bool center_horiz_longest>
+class CenteredLayout : public PageLayout {
+ public:
+  TextRow getRow(const PageBuffer &page, const PageShape &shape,
+                 size_t row) const override {
+    const size_t top =
+        center_vert ? ((page.rows() - shape.lines) / 2) : shape.top;
+    if ((row < top) || (row - top >= shape.lines)) {
+      return TextRow();
+    }
+    const size_t page_row = shape.first_row + row - top;
+    const int start_column =
+        center_horiz ? ((page.width() - lineLen(page, shape, page_row)) / 2)
+                     : 0;
+    return TextRow(start_column, page, page_row, page.lineLen(page_row));
+  }
+
+  TextRow getLine(const PageBuffer &page, const PageShape &shape,
+                  size_t row) const override {
+    // Line is output up to '\0', which also ends it when file has '\0'
+    TextRow line(0, page, row, page.textLen(row));
+    if (center_horiz) {
+      line.padding = (page.width() - lineLen(page, shape, row)) / 2;
+    }
+    return line;
+  }
+
+  void fillGrid(const PageBuffer &page, const PageShape &shape,
+                TextGrid &grid) const override {
+    const size_t width = page.width();
+
+    grid.resize(width, page.rows());
+    for (size_t row = 0; row < page.rows(); ++row) {
+      const TextRow text_row = CenteredLayout::getRow(page, shape, row);
+      size_t column = 0;
+      for (; (column < text_row.padding) && (column < width); ++column) {
+        grid.set(column, row, L' ');
+      }
+      for (size_t i = 0; (i < text_row.size) && (column < width);
+           ++i, ++column) {
+        const wchar_t symbol = text_row.symbol(i);
+        grid.set(column, row,
+                 ((symbol != '\n') && (symbol != '\r')) ? symbol : L' ');
+      }
+      for (; column < width; ++column) {
+        grid.set(column, row, L' ');
+      }
+    }
+  }
+
+ private:
+  static size_t lineLen(const PageBuffer &page, const PageShape &shape,
+                        size_t row) {
+    return center_horiz_longest ? shape.longest_line_len : page.lineLen(row);
+  }
+};
@@ -0,0 +1,96 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "palette.h"
+
+static const int basic_colors[] = {0x000000, 0xcd0000, 0x00cd00, 0xcdcd00,
+                                   0x0000ee, 0xcd00cd, 0x00cdcd, 0xe5e5e5,
+                                   0x7f7f7f, 0xff0000, 0x00ff00, 0xffff00,
+                                   0x5c5cff, 0xff00ff, 0x00ffff, 0xffffff};
+static const int basic_colors_size = 16;
+static const int cube_start = 16;
+static const int gray_start = 232;
+static const int palette_size_max = 256;
+
+static int cubeLevel(int step) {
+  return step ? 55 + step * 40 : 0;
+}
+
+// Index of the closest level of the color cube
+static int cubeStep(int value) {
+  if (value < 48) {
+    return 0;
+  }
+  if (value < 115) {
+    return 1;
+  }
+  return (value - 35) / 40;
+}
+
+int colorDistance(int rgb_1, int rgb_2) {
+  const int red = ((rgb_1 >> 16) & 0xff) - ((rgb_2 >> 16) & 0xff);
+  const int green = ((rgb_1 >> 8) & 0xff) - ((rgb_2 >> 8) & 0xff);
+  const int blue = (rgb_1 & 0xff) - (rgb_2 & 0xff);
+  return red * red + green * green + blue * blue;
+}
+
+int paletteRgb(int index) {
+  if (index < cube_start) {
+    return basic_colors[index];
+  }
+  if (index < gray_start) {
+    index -= cube_start;
+    return (cubeLevel(index / 36) << 16) | (cubeLevel(index / 6 % 6) << 8)
+           | cubeLevel(index % 6);
+  }
+  const int gray = 8 + (index - gray_start) * 10;
+  return (gray << 16) | (gray << 8) | gray;
+}
+
+int nearestPaletteColor(int rgb, int palette_size) {
+  if (palette_size >= palette_size_max) {
+    const int red = (rgb >> 16) & 0xff;
+    const int green = (rgb >> 8) & 0xff;
+    const int blue = rgb & 0xff;
+    const int cube = cube_start + cubeStep(red) * 36 + cubeStep(green) * 6
+                     + cubeStep(blue);
+    int gray_step = ((red + green + blue) / 3 - 3) / 10;
+    gray_step = (gray_step < 0) ? 0 : ((gray_step > 23) ? 23 : gray_step);
+    const int gray = gray_start + gray_step;
+    return (colorDistance(rgb, paletteRgb(gray))
+            < colorDistance(rgb, paletteRgb(cube)))
+               ? gray
+               : cube;
+  }
+
+  // Palettes other than the 256-color one differ between terminals, only
+  // basic colors are known
+  const int size =
+      (palette_size < basic_colors_size) ? palette_size : basic_colors_size;
+  int nearest = 0;
+  for (int i = 1; i < size; ++i) {
+    if (colorDistance(rgb, basic_colors[i])
+        < colorDistance(rgb, basic_colors[nearest])) {
+      nearest = i;
+    }
+  }
+  return nearest;
+}
@@ -0,0 +1,36 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+// Colors of the xterm 256-color palette and mapping of 24-bit colors to the
+// colors a terminal can show. 24-bit colors are packed as 0xRRGGBB.
+
+// 24-bit value of palette color, indexes 0-15 are the usual xterm defaults,
+// 16-231 is the 6x6x6 color cube and 232-255 is the grayscale ramp
+int paletteRgb(int index);
+
+// Index of the color closest to rgb among the first palette_size colors of
+// the palette
+int nearestPaletteColor(int rgb, int palette_size);
+
+// Squared distance between two 24-bit colors
+int colorDistance(int rgb_1, int rgb_2);
@@ -0,0 +1,151 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "perf_counters.h"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef __linux__
+static const uint64_t event_configs[PerfCounters::EventsNum]{
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+static int openEvent(uint64_t config, int group_fd, bool exclude_kernel) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                     | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  attr.exclude_hv = 1;
+  attr.exclude_kernel = exclude_kernel;
+
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+#endif
+
+PerfCounters::PerfCounters() {
+  for (int i = 0; i < EventsNum; ++i) {
+    fds[i] = -1;
+    positions[i] = -1;
+  }
+#ifdef __linux__
+  bool exclude_kernel = false;
+  fds[Cycles] = openEvent(event_configs[Cycles], -1, exclude_kernel);
+  if ((fds[Cycles] == -1) && ((errno == EACCES) || (errno == EPERM))) {
+    // Unprivileged users may be allowed to count user space only
+    exclude_kernel = true;
+    fds[Cycles] = openEvent(event_configs[Cycles], -1, exclude_kernel);
+  }
+  if (fds[Cycles] == -1) {
+    error = std::string("perf_event_open failed: ") + strerror(errno);
+    return;
+  }
+  positions[Cycles] = events_opened++;
+
+  for (int i = Cycles + 1; i < EventsNum; ++i) {
+    fds[i] = openEvent(event_configs[i], fds[Cycles], exclude_kernel);
+    if (fds[i] != -1) {
+      positions[i] = events_opened++;
+    }
+  }
+#else
+  error = "hardware counters are supported only on Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+  // Group members are closed before leader
+  for (int i = EventsNum - 1; i >= 0; --i) {
+    if (fds[i] != -1) {
+      close(fds[i]);
+    }
+  }
+}
+
+bool PerfCounters::isAvailable() const {
+  return events_opened;
+}
+
+bool PerfCounters::isSupported(Event event) const {
+  return positions[event] != -1;
+}
+
+const std::string &PerfCounters::getError() const {
+  return error;
+}
+
+bool PerfCounters::read(Values &values) const {
+  // Number of events, time enabled, time running and values of events
+  const int header_size = 3;
+  uint64_t buf[header_size + EventsNum];
+  const ssize_t size = (header_size + events_opened) * sizeof(buf[0]);
+
+  if (!events_opened || (::read(fds[Cycles], buf, size) != size)) {
+    return false;
+  }
+  values.time_enabled = buf[1];
+  values.time_running = buf[2];
+  for (int i = 0; i < EventsNum; ++i) {
+    if (positions[i] != -1) {
+      values.value[i] = buf[header_size + positions[i]];
+    }
+  }
+  return true;
+}
+
+const char *PerfCounters::getName(Event event) {
+  static const char *names[EventsNum]{"cycles", "instructions",
+                                      "cache_misses", "branch_misses"};
+  return names[event];
+}
+
+PerfScope::PerfScope(PerfTotals *totals) : totals(totals) {
+  if (totals) {
+    started = totals->counters->read(start);
+  }
+}
+
+PerfScope::~PerfScope() {
+  PerfCounters::Values end;
+  if (!started || !totals->counters->read(end)) {
+    return;
+  }
+  const uint64_t enabled = end.time_enabled - start.time_enabled;
+  const uint64_t running = end.time_running - start.time_running;
+  if (!running) {
+    return;
+  }
+  // Multiplexed counters saw only part of the scope, the rest is estimated
+  const double scale = static_cast<double>(enabled) / running;
+  ++totals->calls;
+  for (int i = 0; i < PerfCounters::EventsNum; ++i) {
+    const uint64_t delta = end.value[i] - start.value[i];
+    totals->values.value[i] +=
+        (enabled == running) ? delta : static_cast<uint64_t>(delta * scale);
+  }
+}
@@ -0,0 +1,78 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+// Hardware counters of calling thread, read with perf_event_open. Counters
+// which are not supported by CPU are skipped, if none can be opened, for
+// example when access is denied by kernel.perf_event_paranoid, object is
+// not available and getError() tells why.
+class PerfCounters {
+ public:
+  enum Event { Cycles, Instructions, CacheMisses, BranchMisses, EventsNum };
+  struct Values {
+    uint64_t value[EventsNum] = {};
+    // Nanoseconds the group was enabled and actually counting, they differ
+    // when kernel multiplexes counters on hosts with few PMU slots
+    uint64_t time_enabled = 0;
+    uint64_t time_running = 0;
+  };
+
+  PerfCounters();
+  ~PerfCounters();
+  bool isAvailable() const;
+  bool isSupported(Event event) const;
+  const std::string &getError() const;
+  // Reads all counters with one syscall, returns false if they can't be read
+  bool read(Values &values) const;
+  static const char *getName(Event event);
+
+ private:
+  int fds[EventsNum];
+  // Position of event value in group read, -1 if event is not supported
+  int positions[EventsNum];
+  int events_opened = 0;
+  std::string error;
+};
+
+// Counter deltas accumulated over all runs of a scope
+struct PerfTotals {
+  const PerfCounters *counters = nullptr;
+  uint64_t calls = 0;
+  PerfCounters::Values values;
+};
+
+// Adds counter deltas from construction to destruction to totals, scaled
+// by the share of time counters were running. Does nothing if totals are
+// nullptr, if counters can't be read or if they were not scheduled at all.
+class PerfScope {
+ public:
+  PerfScope(PerfTotals *totals);
+  ~PerfScope();
+
+ private:
+  PerfTotals *totals;
+  PerfCounters::Values start;
+  bool started = false;
+};
@@ -0,0 +1,374 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "plain_pipeline.h"
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include "config.h"
+#include "file_io.h"
+#include "file_reader.h"
+#include "io_counters.h"
+#include "output_writer.h"
+#include "stats.h"
+#include "terminal.h"
+
+static const size_t input_chunk_size = 1 << 16;
+static const size_t text_chunk_size = 1 << 14;
+static const size_t chunks_num = 16;
+// Reader thread checks if pipeline is stopped while it waits for input
+static const int poll_timeout_ms = 100;
+
+// Decodes symbols from chunks of reader thread the same way FileIO does it
+// when reading forward
+class PlainPipeline::QueueInput : public SymbolInput {
+ public:
+  QueueInput(PlainPipeline &pipeline) : pipeline(pipeline) {}
+  Status read(wchar_t &symbol) override;
+  void unread() override;
+  // Is called after End is returned, returns false after the last file
+  bool nextFile();
+  // Time spent waiting for input and writer since the previous call
+  uint64_t takeWaitTime();
+
+ private:
+  PlainPipeline &pipeline;
+  InputChunk *chunk = nullptr;
+  size_t chunk_pos = 0;
+  char last_byte = 0;
+  bool byte_unread = false;
+  bool file_ended = false;
+  bool input_ended = false;
+  size_t file_index = 0;
+  char mbchar_buf[mbchar_size];
+  size_t mbchar_id = 0;
+  uint64_t wait_time = 0;
+
+  Status readByte(char &byte);
+};
+
+SymbolInput::Status PlainPipeline::QueueInput::readByte(char &byte) {
+  if (byte_unread) {
+    byte_unread = false;
+    byte = last_byte;
+    return Status::Ok;
+  }
+  if (file_ended) {
+    return Status::End;
+  }
+
+  while (!chunk || (chunk_pos == chunk->size)) {
+    if (chunk) {
+      pipeline.free_input_queue.push(chunk);
+      chunk = nullptr;
+    }
+    const uint64_t wait_start = pipeline.layout_time ? Stats::now() : 0;
+    // Text laid out so far is written while reader waits for input
+    if (pipeline.input_queue.isEmpty()) {
+      pipeline.sendText();
+    }
+    const bool popped = pipeline.input_queue.pop(chunk);
+    if (pipeline.layout_time) {
+      wait_time += Stats::now() - wait_start;
+    }
+    if (!popped) {
+      // Pipeline is stopped
+      input_ended = true;
+      file_ended = true;
+      return Status::End;
+    }
+    chunk_pos = 0;
+    const Status status = chunk->status;
+    if (status != Status::Ok) {
+      pipeline.free_input_queue.push(chunk);
+      chunk = nullptr;
+      file_ended = (status == Status::End);
+      return status;
+    }
+  }
+
+  byte = chunk->data[chunk_pos++];
+  last_byte = byte;
+  return Status::Ok;
+}
+
+SymbolInput::Status PlainPipeline::QueueInput::read(wchar_t &symbol) {
+  mbstate_t mbs;
+  symbol = '\0';
+  bool symbol_decoded = false;
+
+  for (; mbchar_id < mbchar_size; ++mbchar_id) {
+    const Status read_res = readByte(mbchar_buf[mbchar_id]);
+    if (read_res != Status::Ok) {
+      if ((read_res == Status::End) && mbchar_id) {
+        mbchar_id = 0;
+        symbol = L'\ufffd';
+        return Status::Ok;
+      }
+      return read_res;
+    }
+
+    memset(&mbs, 0, sizeof(mbs));
+    size_t res = mbrtowc(&symbol, mbchar_buf, mbchar_id + 1, &mbs);
+
+    if (res == static_cast<size_t>(-2)) {
+      continue;
+    } else if (res != static_cast<size_t>(-1)) {
+      symbol_decoded = true;
+    }
+    break;
+  }
+  if (!symbol_decoded) {
+    symbol = L'\ufffd';
+  }
+  mbchar_id = 0;
+  return Status::Ok;
+}
+
+void PlainPipeline::QueueInput::unread() {
+  byte_unread = true;
+}
+
+bool PlainPipeline::QueueInput::nextFile() {
+  if (input_ended || (file_index + 1 >= pipeline.files.size())) {
+    return false;
+  }
+  file_ended = false;
+  ++file_index;
+  ++pipeline.counters.file_switches;
+  pipeline.counters.file_index = file_index;
+  return true;
+}
+
+uint64_t PlainPipeline::QueueInput::takeWaitTime() {
+  const uint64_t time = wait_time;
+  wait_time = 0;
+  return time;
+}
+
+PlainPipeline::PlainPipeline(const Config &config, const Terminal &terminal,
+                             Stats &stats)
+    : config(config),
+      terminal(terminal),
+      counters(stats.getIoCounters()),
+      read_time(stats.getHistogram("read")),
+      layout_time(stats.getHistogram("layout")),
+      input_chunks(chunks_num),
+      text_chunks(chunks_num),
+      input_queue(chunks_num),
+      free_input_queue(chunks_num),
+      text_queue(chunks_num),
+      free_text_queue(chunks_num) {
+  for (auto name : config.files) {
+    files.push_back(std::make_unique<FileIO>(name, counters));
+  }
+
+  if (!files.size()) {
+    if (terminal.stdinIsTty()) {
+      throw std::runtime_error(
+          "Please, specify input files or pipe something "
+          "to program input");
+    }
+    files.push_back(std::make_unique<FileIO>(terminal.stdinFd(), counters));
+  }
+
+  for (auto &chunk : input_chunks) {
+    chunk.data.resize(input_chunk_size);
+    free_input_queue.tryPush(&chunk);
+  }
+  for (auto &chunk : text_chunks) {
+    chunk.data.resize(text_chunk_size);
+    chunk.size = 0;
+    free_text_queue.tryPush(&chunk);
+  }
+}
+
+PlainPipeline::~PlainPipeline() = default;
+
+bool PlainPipeline::isSupported(const Config &config) {
+  return !config.infinite;
+}
+
+void PlainPipeline::run() {
+  std::thread reader(&PlainPipeline::runStage, this, &PlainPipeline::readStage);
+  std::thread layout(&PlainPipeline::runStage, this,
+                     &PlainPipeline::layoutStage);
+  runStage(&PlainPipeline::writeStage);
+  reader.join();
+  layout.join();
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void PlainPipeline::runStage(void (PlainPipeline::*stage)()) {
+  try {
+    (this->*stage)();
+  } catch (...) {
+    fail(std::current_exception());
+  }
+}
+
+void PlainPipeline::fail(std::exception_ptr stage_error) {
+  {
+    std::lock_guard<std::mutex> lock(error_mutex);
+    if (!error) {
+      error = stage_error;
+    }
+  }
+  stopping.store(true);
+  input_queue.close();
+  free_input_queue.close();
+  text_queue.close();
+  free_text_queue.close();
+}
+
+void PlainPipeline::readStage() {
+  for (auto &file : files) {
+    SymbolInput::Status status = SymbolInput::Status::Ok;
+
+    while (status != SymbolInput::Status::End) {
+      InputChunk *chunk;
+      if (!free_input_queue.pop(chunk)) {
+        return;
+      }
+      {
+        StatsTimer timer(read_time);
+        status = file->readChunk(chunk->data.data(), chunk->data.size(),
+                                 chunk->size);
+      }
+      chunk->status = status;
+      if (!input_queue.push(chunk)) {
+        return;
+      }
+
+      while ((status == SymbolInput::Status::WouldBlock) && !stopping.load()) {
+        pollfd pfd{file->fno(), POLLIN, 0};
+        if (poll(&pfd, 1, poll_timeout_ms) > 0) {
+          break;
+        }
+      }
+    }
+    file->stop();
+  }
+  input_queue.close();
+}
+
+void PlainPipeline::layoutStage() {
+  QueueInput input(*this);
+  FileReader reader(config, terminal);
+  const size_t block_lines =
+      (config.block_lines < 0) ? terminal.getHeight() : config.block_lines;
+  TextRow line;
+  uint64_t page_start = layout_time ? Stats::now() : 0;
+
+  // Same page boundaries as in FileStream
+  reader.newPage(Direction::Forward);
+  while (true) {
+    if (!reader.read(input)) {
+      if ((reader.linesRead() < block_lines) || reader.linePartial()) {
+        continue;
+      }
+    } else if (!reader.linesRead()) {
+      if (!input.nextFile()) {
+        break;
+      }
+      continue;
+    }
+
+    // Page is laid out while it is read, waits for input are not counted
+    if (layout_time) {
+      layout_time->record(Stats::now() - page_start - input.takeWaitTime());
+    }
+    counters.lines_read += reader.linesRead();
+    ++counters.pages_forward;
+    while (reader.getLine(line)) {
+      addText(line);
+    }
+    reader.newPage(Direction::Forward);
+    if (layout_time) {
+      page_start = Stats::now();
+      input.takeWaitTime();
+    }
+  }
+
+  sendText();
+  text_queue.close();
+}
+
+void PlainPipeline::addText(const TextRow &line) {
+  size_t pos = 0;
+  const size_t line_size = line.padding + line.size;
+
+  while (pos < line_size) {
+    if (!text_chunk && !free_text_queue.pop(text_chunk)) {
+      return;
+    }
+    wchar_t *out = text_chunk->data.data() + text_chunk->size;
+    const size_t len =
+        std::min(line_size - pos, text_chunk->data.size() - text_chunk->size);
+    const size_t spaces =
+        (pos < line.padding) ? std::min(len, line.padding - pos) : 0;
+    std::fill(out, out + spaces, L' ');
+    for (size_t i = spaces; i < len; ++i) {
+      out[i] = line.symbol(pos + i - line.padding);
+    }
+    text_chunk->size += len;
+    pos += len;
+    if (text_chunk->size == text_chunk->data.size()) {
+      sendText();
+    }
+  }
+}
+
+void PlainPipeline::sendText() {
+  if (!text_chunk || !text_chunk->size) {
+    return;
+  }
+  text_queue.push(text_chunk);
+  text_chunk = nullptr;
+}
+
+void PlainPipeline::writeStage() {
+  OutputWriter output(STDOUT_FILENO);
+  TextChunk *chunk;
+
+  while (!stopping.load()) {
+    if (!text_queue.tryPop(chunk)) {
+      // Text is shown as soon as layout thread waits for input
+      output.flush();
+      if (!text_queue.pop(chunk)) {
+        break;
+      }
+    }
+    output.write(chunk->data.data(), chunk->size);
+    chunk->size = 0;
+    free_text_queue.push(chunk);
+  }
+  if (!stopping.load()) {
+    output.flush();
+  }
+}
@@ -0,0 +1,97 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+#include <exception>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "spsc_queue.h"
+#include "symbol_input.h"
+#include "text_row.h"
+
+class Config;
+class Histogram;
+class Terminal;
+class Stats;
+class FileIO;
+struct IoCounters;
+
+// Plain mode, in which input is read, laid out and written by separate
+// threads connected by bounded queues. Output is the same as of ManagerPlain.
+class PlainPipeline {
+ public:
+  PlainPipeline(const Config &config, const Terminal &terminal, Stats &stats);
+  ~PlainPipeline();
+  // Pipeline does not keep input for reading it again, so it can't show
+  // files in infinite loop
+  static bool isSupported(const Config &config);
+  // Returns when all input is written, rethrows first error of any stage
+  void run();
+
+ private:
+  class QueueInput;
+  // Data read by one syscall, or marker of input end or of input having
+  // no data yet
+  struct InputChunk {
+    SymbolInput::Status status;
+    std::vector<char> data;
+    size_t size;
+  };
+  struct TextChunk {
+    std::vector<wchar_t> data;
+    size_t size;
+  };
+
+  const Config &config;
+  const Terminal &terminal;
+  IoCounters &counters;
+  // Histograms are created before threads start, as Stats keeps them in map
+  Histogram *read_time;
+  Histogram *layout_time;
+  std::list<std::unique_ptr<FileIO>> files;
+  std::vector<InputChunk> input_chunks;
+  std::vector<TextChunk> text_chunks;
+  // Chunks go from reader to layout thread and back
+  SpscQueue<InputChunk *> input_queue;
+  SpscQueue<InputChunk *> free_input_queue;
+  // Chunks go from layout to writer thread and back
+  SpscQueue<TextChunk *> text_queue;
+  SpscQueue<TextChunk *> free_text_queue;
+  // Is filled by layout thread
+  TextChunk *text_chunk = nullptr;
+  std::atomic<bool> stopping{false};
+  std::mutex error_mutex;
+  std::exception_ptr error;
+
+  void runStage(void (PlainPipeline::*stage)());
+  void fail(std::exception_ptr stage_error);
+  void readStage();
+  void layoutStage();
+  void writeStage();
+  void addText(const TextRow &line);
+  void sendText();
+};
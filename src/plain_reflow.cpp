@@ -0,0 +1,331 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "plain_reflow.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <langinfo.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include "file_reader.h"
+#include "io_counters.h"
+#include "output_writer.h"
+#include "stats.h"
+#include "symbol_input.h"
+#include "terminal.h"
+
+// Chunk is extended to the next line end, which is usually close
+static const size_t chunk_size = 1 << 20;
+// Chunks laid out at once by every thread of the pool, more chunks balance
+// uneven lines better but take more memory
+static const size_t chunks_per_thread = 4;
+
+// Decodes symbols of mapped file the same way FileIO does it when reading
+// forward
+class PlainReflow::MemoryInput : public SymbolInput {
+ public:
+  MemoryInput(const char *begin, const char *end, bool utf8)
+      : pos(begin), end(end), utf8(utf8) {}
+  Status read(wchar_t &symbol) override;
+  void unread() override;
+
+ private:
+  const char *pos;
+  const char *end;
+  bool utf8;
+};
+
+SymbolInput::Status PlainReflow::MemoryInput::read(wchar_t &symbol) {
+  symbol = '\0';
+  if (pos == end) {
+    return Status::End;
+  }
+  // ASCII byte is the whole symbol in UTF-8
+  if (utf8 && !(*pos & 0x80)) {
+    symbol = *pos++;
+    return Status::Ok;
+  }
+
+  mbstate_t mbs;
+  const size_t size = std::min<size_t>(mbchar_size, end - pos);
+  for (size_t len = 1; len <= size; ++len) {
+    memset(&mbs, 0, sizeof(mbs));
+    const size_t res = mbrtowc(&symbol, pos, len, &mbs);
+    if (res == static_cast<size_t>(-2)) {
+      continue;
+    }
+    if (res == static_cast<size_t>(-1)) {
+      symbol = L'\ufffd';
+    }
+    pos += len;
+    return Status::Ok;
+  }
+  // Symbol is too long or is cut by the end of file
+  symbol = L'\ufffd';
+  pos += size;
+  return Status::Ok;
+}
+
+void PlainReflow::MemoryInput::unread() {
+  --pos;
+}
+
+PlainReflow::PlainReflow(const Config &config, const Terminal &terminal,
+                         Stats &stats)
+    : config(config),
+      layout_config(config),
+      terminal(terminal),
+      counters(stats.getIoCounters()),
+      read_time(stats.getHistogram("read")),
+      layout_time(stats.getHistogram("layout")),
+      chunks(pool.size() * chunks_per_thread),
+      utf8(!strcmp(nl_langinfo(CODESET), "UTF-8")),
+      center_by_page(config.center_horiz && config.center_horiz_longest),
+      page_size(terminal.getHeight()),
+      padding(terminal.getWidth(), ' ') {
+  if (center_by_page) {
+    layout_config.center_horiz = false;
+  }
+  for (auto &chunk : chunks) {
+    chunk.reader = std::make_unique<FileReader>(layout_config, terminal);
+  }
+
+  for (auto name : config.files) {
+    const int fd = open(name, O_RDONLY);
+    if (fd == -1) {
+      std::ostringstream err;
+      err << "Can't open file '" << name << "': " << strerror(errno);
+      throw std::runtime_error(err.str());
+    }
+    files.push_back({name, fd});
+  }
+}
+
+PlainReflow::~PlainReflow() {
+  for (auto &file : files) {
+    close(file.fd);
+  }
+}
+
+bool PlainReflow::isSupported(const Config &config) {
+  if (config.infinite || config.files.empty()) {
+    return false;
+  }
+  // Line end may be a part of multibyte symbol in other charsets
+  if ((MB_CUR_MAX > 1) && strcmp(nl_langinfo(CODESET), "UTF-8")) {
+    return false;
+  }
+  for (auto name : config.files) {
+    struct stat file_stat;
+    if (stat(name, &file_stat) || !S_ISREG(file_stat.st_mode)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PlainReflow::run() {
+  OutputWriter output(STDOUT_FILENO);
+
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (i) {
+      ++counters.file_switches;
+      counters.file_index = i;
+    }
+    showFile(files[i], output);
+  }
+  output.flush();
+}
+
+void PlainReflow::showFile(const InputFile &file, OutputWriter &output) {
+  struct stat file_stat;
+  if (fstat(file.fd, &file_stat)) {
+    std::ostringstream err;
+    err << "Can't get file '" << file.name << "' stat: " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+  const size_t size = file_stat.st_size;
+  if (!size) {
+    return;
+  }
+
+  void *data;
+  {
+    StatsTimer timer(read_time);
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+  }
+  ++counters.syscalls;
+  if (data == MAP_FAILED) {
+    std::ostringstream err;
+    err << "Can't map file '" << file.name << "': " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+  madvise(data, size, MADV_SEQUENTIAL);
+  counters.bytes_read += size;
+
+  const char *pos = static_cast<const char *>(data);
+  const char *end = pos + size;
+  const auto layout = [this](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      layoutChunk(chunks[i]);
+    }
+  };
+
+  try {
+    while (pos < end) {
+      size_t count = 0;
+      for (; (count < chunks.size()) && (pos < end); ++count) {
+        chunks[count].begin = pos;
+        pos = splitChunk(pos, end);
+        chunks[count].end = pos;
+      }
+      pool.run(count, layout);
+      for (size_t i = 0; i < count; ++i) {
+        if (layout_time) {
+          layout_time->record(chunks[i].layout_time);
+        }
+        writeChunk(chunks[i], output);
+      }
+    }
+    // Pages start again in every file
+    writePage(output);
+  } catch (...) {
+    munmap(data, size);
+    throw;
+  }
+  munmap(data, size);
+}
+
+const char *PlainReflow::splitChunk(const char *begin, const char *end) const {
+  const char *pos =
+      begin + std::min(chunk_size, static_cast<size_t>(end - begin));
+
+  while (pos < end) {
+    auto line_end = static_cast<const char *>(memchr(pos, '\n', end - pos));
+    if (!line_end) {
+      break;
+    }
+    // After ASCII byte no symbol is being decoded, otherwise line end may
+    // be taken as the end of invalid sequence
+    if (!(line_end[-1] & 0x80)) {
+      return line_end + 1;
+    }
+    pos = line_end + 1;
+  }
+  return end;
+}
+
+void PlainReflow::layoutChunk(Chunk &chunk) {
+  MemoryInput input(chunk.begin, chunk.end, utf8);
+  FileReader &reader = *chunk.reader;
+  const size_t symbol_max_size = chunk.encoder.symbolMaxSize();
+  const uint64_t start = layout_time ? Stats::now() : 0;
+
+  chunk.size = 0;
+  chunk.lines_num = 0;
+  chunk.line_ends.clear();
+  chunk.line_lens.clear();
+  while (true) {
+    // Chunk has no pending input, so page is read at once
+    reader.newPage(Direction::Forward);
+    reader.read(input);
+    if (!reader.linesRead()) {
+      break;
+    }
+    for (size_t row = 0; reader.getLine(chunk.line); ++row) {
+      const TextRow &line = chunk.line;
+      const size_t max_size = line.padding + line.size * symbol_max_size;
+      if (chunk.text.size() - chunk.size < max_size) {
+        chunk.text.resize(
+            std::max(chunk.size + max_size, chunk.text.size() * 2));
+      }
+      char *out = chunk.text.data() + chunk.size;
+      memset(out, ' ', line.padding);
+      out += line.padding;
+      for (size_t i = 0; i < line.size; ++i) {
+        out = chunk.encoder.encode(line.symbol(i), out);
+      }
+      chunk.size = out - chunk.text.data();
+      if (center_by_page) {
+        chunk.line_ends.push_back(chunk.size);
+        chunk.line_lens.push_back(reader.lineLen(row));
+      }
+    }
+    chunk.lines_num += reader.linesRead();
+  }
+  if (layout_time) {
+    chunk.layout_time = Stats::now() - start;
+  }
+}
+
+void PlainReflow::writeChunk(const Chunk &chunk, OutputWriter &output) {
+  counters.lines_read += chunk.lines_num;
+  if (!center_by_page) {
+    output.writeBytes(chunk.text.data(), chunk.size);
+    page_lines += chunk.lines_num;
+    counters.pages_forward += page_lines / page_size;
+    page_lines %= page_size;
+    return;
+  }
+
+  size_t line_begin = 0;
+  for (size_t i = 0; i < chunk.line_ends.size(); ++i) {
+    addPageLine(chunk.text.data() + line_begin,
+                chunk.line_ends[i] - line_begin, chunk.line_lens[i], output);
+    line_begin = chunk.line_ends[i];
+  }
+}
+
+void PlainReflow::addPageLine(const char *line, size_t size, size_t line_len,
+                              OutputWriter &output) {
+  page_text.insert(page_text.end(), line, line + size);
+  page_line_ends.push_back(page_text.size());
+  page_longest = std::max(page_longest, line_len);
+  if (++page_lines == page_size) {
+    writePage(output);
+  }
+}
+
+void PlainReflow::writePage(OutputWriter &output) {
+  if (!page_lines) {
+    return;
+  }
+  if (center_by_page) {
+    const size_t padding_len = (padding.size() - page_longest) / 2;
+    size_t line_begin = 0;
+    for (auto line_end : page_line_ends) {
+      output.writeBytes(padding.data(), padding_len);
+      output.writeBytes(page_text.data() + line_begin, line_end - line_begin);
+      line_begin = line_end;
+    }
+    page_text.clear();
+    page_line_ends.clear();
+    page_longest = 0;
+  }
+  ++counters.pages_forward;
+  page_lines = 0;
+}
@@ -0,0 +1,107 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include "config.h"
+#include "text_encoder.h"
+#include "text_row.h"
+#include "worker_pool.h"
+
+class Histogram;
+class Terminal;
+class Stats;
+class FileReader;
+class OutputWriter;
+struct IoCounters;
+
+// Plain mode for regular files. Every file is mapped to memory and split
+// into chunks ending at line ends, where page layout does not depend on
+// preceding text, so chunks are laid out and encoded in parallel and then
+// written in order. Output is the same as of ManagerPlain.
+class PlainReflow {
+ public:
+  PlainReflow(const Config &config, const Terminal &terminal, Stats &stats);
+  ~PlainReflow();
+  // All inputs have to be regular files shown once, in locale in which
+  // line end can't be a part of multibyte symbol
+  static bool isSupported(const Config &config);
+  void run();
+
+ private:
+  class MemoryInput;
+  struct Chunk {
+    const char *begin;
+    const char *end;
+    std::unique_ptr<FileReader> reader;
+    TextRow line;
+    TextEncoder encoder;
+    // Encoded text of chunk
+    std::vector<char> text;
+    size_t size;
+    // Ends of lines in text and their lengths in symbols, they are kept
+    // only when lines are centered by the longest line of page
+    std::vector<size_t> line_ends;
+    std::vector<size_t> line_lens;
+    size_t lines_num;
+    // Is recorded by writing thread, as chunks are laid out in parallel
+    uint64_t layout_time;
+  };
+
+  struct InputFile {
+    const char *name;
+    int fd;
+  };
+
+  const Config &config;
+  // Centering by the longest line is done when chunks are joined to pages
+  Config layout_config;
+  const Terminal &terminal;
+  IoCounters &counters;
+  // Pages of mapped file are read while chunks are laid out, so read time
+  // is only the time of mapping
+  Histogram *read_time;
+  Histogram *layout_time;
+  WorkerPool pool;
+  std::vector<InputFile> files;
+  std::vector<Chunk> chunks;
+  bool utf8;
+  bool center_by_page;
+  size_t page_size;
+  // Lines of page which is not complete yet
+  std::vector<char> page_text;
+  std::vector<size_t> page_line_ends;
+  size_t page_lines = 0;
+  size_t page_longest = 0;
+  std::vector<char> padding;
+
+  void showFile(const InputFile &file, OutputWriter &output);
+  const char *splitChunk(const char *begin, const char *end) const;
+  void layoutChunk(Chunk &chunk);
+  void writeChunk(const Chunk &chunk, OutputWriter &output);
+  void addPageLine(const char *line, size_t size, size_t line_len,
+                   OutputWriter &output);
+  void writePage(OutputWriter &output);
+};
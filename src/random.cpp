@@ -0,0 +1,111 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "random.h"
+#include <string.h>
+
+typedef uint32_t Lanes __attribute__((vector_size(16)));
+
+static inline uint32_t rotl(uint32_t x, int k) {
+  return (x << k) | (x >> (32 - k));
+}
+
+static inline Lanes rotl(Lanes x, int k) {
+  return (x << k) | (x >> (32 - k));
+}
+
+static uint64_t splitMix(uint64_t &seed) {
+  uint64_t z = (seed += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+Random::Random(uint64_t _seed) {
+  seed(_seed);
+}
+
+void Random::seed(uint64_t seed) {
+  for (size_t i = 0; i < 4; i += 2) {
+    const uint64_t value = splitMix(seed);
+    state[i] = value;
+    state[i + 1] = value >> 32;
+  }
+  for (auto &lane_state : lanes) {
+    for (size_t i = 0; i < lanes_num; i += 2) {
+      const uint64_t value = splitMix(seed);
+      lane_state[i] = value;
+      lane_state[i + 1] = value >> 32;
+    }
+  }
+}
+
+uint32_t Random::next() {
+  const uint32_t result = rotl(state[0] + state[3], 7) + state[0];
+  const uint32_t t = state[1] << 9;
+
+  state[2] ^= state[0];
+  state[3] ^= state[1];
+  state[1] ^= state[2];
+  state[0] ^= state[3];
+  state[2] ^= t;
+  state[3] = rotl(state[3], 11);
+
+  return result;
+}
+
+uint32_t Random::next(uint32_t limit) {
+  return (static_cast<uint64_t>(next()) * limit) >> 32;
+}
+
+void Random::fill(uint32_t *values, size_t num) {
+  static_assert(sizeof(Lanes) == sizeof(lanes[0]), "Wrong lanes size");
+  Lanes s0, s1, s2, s3;
+  size_t i = 0;
+
+  memcpy(&s0, lanes[0], sizeof(s0));
+  memcpy(&s1, lanes[1], sizeof(s1));
+  memcpy(&s2, lanes[2], sizeof(s2));
+  memcpy(&s3, lanes[3], sizeof(s3));
+
+  for (; i + lanes_num <= num; i += lanes_num) {
+    const Lanes result = rotl(s0 + s3, 7) + s0;
+    const Lanes t = s1 << 9;
+
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = rotl(s3, 11);
+
+    memcpy(values + i, &result, sizeof(result));
+  }
+
+  memcpy(lanes[0], &s0, sizeof(s0));
+  memcpy(lanes[1], &s1, sizeof(s1));
+  memcpy(lanes[2], &s2, sizeof(s2));
+  memcpy(lanes[3], &s3, sizeof(s3));
+
+  for (; i < num; ++i) {
+    values[i] = next();
+  }
+}
@@ -0,0 +1,42 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// xoshiro128++ generator. Single values come from the scalar state, batches
+// are generated by several independent generators working in SIMD lanes.
+class Random {
+ public:
+  Random(uint64_t seed = 0);
+  void seed(uint64_t seed);
+  uint32_t next();
+  // Returns value in [0, limit)
+  uint32_t next(uint32_t limit);
+  void fill(uint32_t *values, size_t num);
+
+ private:
+  static const size_t lanes_num = 4;
+  uint32_t state[4];
+  uint32_t lanes[4][lanes_num];
+};
@@ -0,0 +1,201 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stdlib.h>
+#include <vector>
+
+// Drawing primitives for animations. Shapes are clipped to a rectangle and
+// passed to callbacks as points or filled rectangles. Callbacks are template
+// parameters, so they are inlined and do not allocate.
+namespace raster {
+
+struct Rect {
+  int x;
+  int y;
+  int width;
+  int height;
+
+  bool contains(int point_x, int point_y) const {
+    return (point_x >= x) && (point_x < x + width) && (point_y >= y)
+           && (point_y < y + height);
+  }
+};
+
+// Calls plot(x, y) for points of line from (x1, y1) to (x2, y2) which are
+// inside of clip. Algorithm taken from
+// http://www.roguebasin.com/index.php?title=Bresenham%27s_Line_Algorithm
+template <typename Plot>
+void line(const Rect &clip, int x1, int y1, int x2, int y2, Plot plot) {
+  // Coordinates of points change monotonically, so once line leaves clip it
+  // does not return
+  const bool inside = clip.contains(x1, y1) && clip.contains(x2, y2);
+  bool entered = false;
+  auto visit = [&](int x, int y) {
+    if (inside || clip.contains(x, y)) {
+      plot(x, y);
+      entered = true;
+      return true;
+    }
+    return !entered;
+  };
+  int x_delta = x2 - x1;
+  int y_delta = y2 - y1;
+  int x_inc = (x_delta > 0) ? 1 : ((x_delta < 0) ? -1 : 0);
+  int y_inc = (y_delta > 0) ? 1 : ((y_delta < 0) ? -1 : 0);
+  x_delta = abs(x_delta * 2);
+  y_delta = abs(y_delta * 2);
+
+  if (!visit(x1, y1)) {
+    return;
+  }
+
+  if (x_delta >= y_delta) {
+    int error = y_delta - (x_delta / 2);
+
+    while (x1 != x2) {
+      if ((error >= 0) && (error || (x_inc > 0))) {
+        error -= x_delta;
+        y1 += y_inc;
+      }
+      error += y_delta;
+      x1 += x_inc;
+      if (!visit(x1, y1)) {
+        return;
+      }
+    }
+  } else {
+    int error = x_delta - (y_delta / 2);
+
+    while (y1 != y2) {
+      if ((error >= 0) && (error || (y_inc > 0))) {
+        error -= y_delta;
+        x1 += x_inc;
+      }
+      error += x_delta;
+      y1 += y_inc;
+      if (!visit(x1, y1)) {
+        return;
+      }
+    }
+  }
+}
+
+// Heights of circle quadrants, floor(sqrt(radius^2 - i^2)) for i from 0 to
+// radius. They are found with integer steps and kept for every radius.
+class CircleTable {
+ public:
+  // Computes heights of all radii up to max_radius, so that drawing does
+  // not allocate
+  void reserve(int max_radius) {
+    if (max_radius <= reserved_radius) {
+      return;
+    }
+    heights.resize(offset(max_radius + 1));
+    for (int radius = reserved_radius + 1; radius <= max_radius; ++radius) {
+      int *out = heights.data() + offset(radius);
+      int height = radius;
+      for (int i = 0; i <= radius; ++i) {
+        while (height * height > radius * radius - i * i) {
+          --height;
+        }
+        out[i] = height;
+      }
+    }
+    reserved_radius = max_radius;
+  }
+  const int *get(int radius) {
+    reserve(radius);
+    return heights.data() + offset(radius);
+  }
+
+ private:
+  std::vector<int> heights;
+  int reserved_radius = -1;
+
+  // Heights of radius start after radius * (radius + 1) / 2 heights of
+  // smaller radii
+  static size_t offset(int radius) {
+    return radius * (radius + 1) / 2;
+  }
+};
+
+// Calls fill(x, y, width, height) with parts of clip covered by rect
+template <typename Fill>
+void fillClipped(const Rect &clip, int x, int y, int width, int height,
+                 Fill &fill) {
+  const int right = (x + width < clip.x + clip.width) ? x + width
+                                                      : clip.x + clip.width;
+  const int bottom = (y + height < clip.y + clip.height)
+                         ? y + height
+                         : clip.y + clip.height;
+  x = (x > clip.x) ? x : clip.x;
+  y = (y > clip.y) ? y : clip.y;
+  if ((x < right) && (y < bottom)) {
+    fill(x, y, right - x, bottom - y);
+  }
+}
+
+// Calls fill(x, y, width, height) for rectangles of circle outline inside of
+// clip. Every point of outline is two columns wide, so that circle looks
+// round on terminal. Bold outline also fills corners of its steps.
+template <typename Fill>
+void circle(const Rect &clip, CircleTable &table, int radius, int center_x,
+            int center_y, bool bold, Fill fill) {
+  if (radius < 0) {
+    return;
+  }
+  const int *heights = table.get(radius);
+
+  for (int quad = 0; quad < 4; ++quad) {
+    const int x_mul = (quad % 2) ? 1 : -1;
+    const int y_mul = (quad >= 2) ? 1 : -1;
+    const int y_shift = (quad >= 2) ? 1 : 0;
+    // Upper quadrants take rows [center_y - radius, center_y], lower ones
+    // take rows [center_y + 1, center_y + radius + 1]
+    const int first_row = center_y + y_shift - ((quad >= 2) ? 0 : radius);
+    if ((first_row + radius < clip.y) || (first_row >= clip.y + clip.height)) {
+      continue;
+    }
+    int prev_h = 0;
+    for (int i = 0; i <= radius; ++i) {
+      const int x = center_x + (i * 2 * x_mul);
+      const int h = heights[i];
+      const int y = center_y + (h * y_mul) + y_shift;
+      const int step = prev_h - h;
+
+      fillClipped(clip, x - 1 + x_mul, y, 2, 1, fill);
+      if (prev_h) {
+        if (step > 1) {
+          fillClipped(clip, x - 1 - x_mul, (y_mul > 0) ? y + 1 : y - step, 2,
+                      step, fill);
+        }
+        if (bold && (step >= 1)) {
+          fillClipped(clip, x - 1 - x_mul, y, 2, 1, fill);
+        }
+      }
+      prev_h = h;
+    }
+  }
+}
+
+}  // namespace raster
@@ -0,0 +1,123 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+// Bounded queue for one producer and one consumer thread. Items are passed
+// without locks, mutex is taken only to put a thread to sleep on empty or
+// full queue and to wake it up.
+template <typename T>
+class SpscQueue {
+ public:
+  SpscQueue(size_t capacity) : items(capacity + 1) {}
+
+  bool tryPush(const T &item) {
+    const size_t cur_tail = tail.load(std::memory_order_relaxed);
+    const size_t next_tail = (cur_tail + 1) % items.size();
+    if (next_tail == head.load(std::memory_order_acquire)) {
+      return false;
+    }
+    items[cur_tail] = item;
+    tail.store(next_tail);
+    wake();
+    return true;
+  }
+
+  bool tryPop(T &item) {
+    const size_t cur_head = head.load(std::memory_order_relaxed);
+    if (cur_head == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = items[cur_head];
+    head.store((cur_head + 1) % items.size());
+    wake();
+    return true;
+  }
+
+  // Waits while queue is full, returns false if queue is closed
+  bool push(const T &item) {
+    while (!closed.load()) {
+      if (tryPush(item)) {
+        return true;
+      }
+      wait([this]() { return !this->isFull(); });
+    }
+    return false;
+  }
+
+  // Waits while queue is empty, returns false if queue is closed and empty
+  bool pop(T &item) {
+    while (true) {
+      if (tryPop(item)) {
+        return true;
+      }
+      if (closed.load()) {
+        return false;
+      }
+      wait([this]() { return !this->isEmpty(); });
+    }
+  }
+
+  // Wakes up both threads, items pushed before are still returned by pop()
+  void close() {
+    closed.store(true);
+    std::lock_guard<std::mutex> lock(mutex);
+    cond.notify_all();
+  }
+
+  bool isEmpty() const {
+    return head.load() == tail.load();
+  }
+
+ private:
+  std::vector<T> items;
+  std::atomic<size_t> head{0};
+  std::atomic<size_t> tail{0};
+  std::atomic<bool> closed{false};
+  std::atomic<int> sleepers{0};
+  std::mutex mutex;
+  std::condition_variable cond;
+
+  bool isFull() const {
+    return (tail.load() + 1) % items.size() == head.load();
+  }
+
+  template <typename Ready>
+  void wait(Ready ready) {
+    std::unique_lock<std::mutex> lock(mutex);
+    ++sleepers;
+    cond.wait(lock, [this, &ready]() { return closed.load() || ready(); });
+    --sleepers;
+  }
+
+  void wake() {
+    if (sleepers.load()) {
+      std::lock_guard<std::mutex> lock(mutex);
+      cond.notify_all();
+    }
+  }
+};
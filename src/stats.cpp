@@ -0,0 +1,339 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "stats.h"
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "config.h"
+
+Stats::Stats(const Config &config)
+    : config(config), hud(config, io_counters) {
+  if (config.stats) {
+    perf_counters = std::make_unique<PerfCounters>();
+  }
+  if (!config.trace_file.empty()) {
+    trace = std::make_unique<Trace>(config.trace_file);
+  }
+}
+
+Stats::~Stats() = default;
+
+Histogram *Stats::getHistogram(const std::string &name, uint64_t deadline) {
+  if (!config.stats && config.metrics_file.empty()) {
+    return nullptr;
+  }
+
+  auto histogram = histograms.find(name);
+  if (histogram == histograms.end()) {
+    histogram = histograms
+                    .emplace(std::piecewise_construct,
+                             std::forward_as_tuple(name),
+                             std::forward_as_tuple(deadline))
+                    .first;
+  }
+  return &histogram->second;
+}
+
+PerfTotals *Stats::getPerfTotals(const std::string &name) {
+  if (!perf_counters || !perf_counters->isAvailable()) {
+    return nullptr;
+  }
+
+  PerfTotals &totals = perf_totals[name];
+  totals.counters = perf_counters.get();
+  return &totals;
+}
+
+AllocTotals *Stats::getAllocTotals(const std::string &name) {
+  if (!config.stats || !AllocCounter::isEnabled()) {
+    return nullptr;
+  }
+  return &alloc_totals[name];
+}
+
+Trace *Stats::getTrace() {
+  return trace.get();
+}
+
+IoCounters &Stats::getIoCounters() {
+  return io_counters;
+}
+
+const IoCounters &Stats::getIoCounters() const {
+  return io_counters;
+}
+
+Hud &Stats::getHud() {
+  return hud;
+}
+
+void Stats::report() const {
+  if (!config.stats) {
+    return;
+  }
+  if (config.stats_file.empty()) {
+    report(stderr);
+    return;
+  }
+
+  FILE *out = fopen(config.stats_file.c_str(), "w");
+  if (!out) {
+    std::ostringstream err;
+    err << "Can't open " << config.stats_file << ": " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+  report(out);
+  fclose(out);
+}
+
+void Stats::report(FILE *out) const {
+  fprintf(out, "%-24s %10s %10s %10s %10s %10s %10s\n", "stage", "count",
+          "p50_ms", "p90_ms", "p99_ms", "max_ms", "missed");
+  for (const auto &item : histograms) {
+    const Histogram &histogram = item.second;
+    if (!histogram.count()) {
+      continue;
+    }
+    fprintf(out, "%-24s %10zu %10.3f %10.3f %10.3f %10.3f %10zu\n",
+            item.first.c_str(), histogram.count(),
+            histogram.percentile(0.5) / 1e6, histogram.percentile(0.9) / 1e6,
+            histogram.percentile(0.99) / 1e6, histogram.max() / 1e6,
+            histogram.missed());
+  }
+
+  if (!alloc_totals.empty()) {
+    fprintf(out, "\n%-24s %10s %10s %10s %10s\n", "allocations", "calls",
+            "total", "per_call", "max");
+  }
+  for (const auto &item : alloc_totals) {
+    const AllocTotals &totals = item.second;
+    if (!totals.calls) {
+      continue;
+    }
+    fprintf(out, "%-24s %10llu %10llu %10.2f %10llu\n", item.first.c_str(),
+            static_cast<unsigned long long>(totals.calls),
+            static_cast<unsigned long long>(totals.allocs),
+            static_cast<double>(totals.allocs) / totals.calls,
+            static_cast<unsigned long long>(totals.max));
+  }
+
+  if (!perf_counters) {
+    return;
+  }
+  if (!perf_counters->isAvailable()) {
+    fprintf(out, "\nhardware counters are not available, %s\n",
+            perf_counters->getError().c_str());
+    return;
+  }
+  fprintf(out, "\n%-24s %10s", "scope, per call", "calls");
+  for (int i = 0; i < PerfCounters::EventsNum; ++i) {
+    fprintf(out, " %13s", PerfCounters::getName(PerfCounters::Event(i)));
+  }
+  fprintf(out, " %7s\n", "ipc");
+  for (const auto &item : perf_totals) {
+    const PerfTotals &totals = item.second;
+    if (!totals.calls) {
+      continue;
+    }
+    fprintf(out, "%-24s %10llu", item.first.c_str(),
+            static_cast<unsigned long long>(totals.calls));
+    for (int i = 0; i < PerfCounters::EventsNum; ++i) {
+      if (perf_counters->isSupported(PerfCounters::Event(i))) {
+        fprintf(out, " %13.1f",
+                static_cast<double>(totals.values.value[i]) / totals.calls);
+      } else {
+        fprintf(out, " %13s", "n/a");
+      }
+    }
+    const uint64_t cycles = totals.values.value[PerfCounters::Cycles];
+    if (cycles && perf_counters->isSupported(PerfCounters::Instructions)) {
+      fprintf(out, " %7.2f",
+              static_cast<double>(
+                  totals.values.value[PerfCounters::Instructions])
+                  / cycles);
+    } else {
+      fprintf(out, " %7s", "n/a");
+    }
+    fprintf(out, "\n");
+  }
+}
+
+static const struct {
+  const char *name;
+  IoCounter IoCounters::*value;
+} counters_info[]{{"syscalls", &IoCounters::syscalls},
+                  {"bytes_read", &IoCounters::bytes_read},
+                  {"seeks", &IoCounters::seeks},
+                  {"would_block", &IoCounters::would_block},
+                  {"cache_hits", &IoCounters::cache_hits},
+                  {"cache_misses", &IoCounters::cache_misses},
+                  {"cache_evicted_bytes", &IoCounters::cache_evicted_bytes},
+                  {"pages_forward", &IoCounters::pages_forward},
+                  {"pages_backward", &IoCounters::pages_backward},
+                  {"file_switches", &IoCounters::file_switches},
+                  {"lines_read", &IoCounters::lines_read},
+                  {"file_index", &IoCounters::file_index}};
+
+void Stats::watchCounters(bool screen_on_stderr) {
+  signal_counters_file = config.counters_file;
+  if (screen_on_stderr && signal_counters_file.empty()) {
+    const char *tmp_dir = getenv("TMPDIR");
+    std::ostringstream path;
+    path << ((tmp_dir && *tmp_dir) ? tmp_dir : "/tmp") << "/mattext-counters-"
+         << getpid() << ".txt";
+    signal_counters_file = path.str();
+  }
+  sig_watcher.set<Stats, &Stats::signalCb>(this);
+  sig_watcher.start(SIGUSR1);
+}
+
+void Stats::signalCb(ev::sig & /*w*/, int /*revents*/) {
+  dumpCounters(signal_counters_file);
+  signal_counters_written = true;
+}
+
+void Stats::dumpCounters() const {
+  dumpCounters(config.counters_file);
+}
+
+void Stats::reportCountersFile() const {
+  if (signal_counters_written && config.counters_file.empty()
+      && !signal_counters_file.empty()) {
+    fprintf(stderr, "Counters were written to %s\n",
+            signal_counters_file.c_str());
+  }
+}
+
+void Stats::dumpCounters(const std::string &path) const {
+  if (path.empty()) {
+    dumpCounters(stderr, false);
+    return;
+  }
+
+  const std::string json_ext = ".json";
+  const bool json = (path.size() >= json_ext.size())
+                    && !path.compare(path.size() - json_ext.size(),
+                                     json_ext.size(), json_ext);
+  writeFile(path, [this, json](FILE *out) { this->dumpCounters(out, json); });
+}
+
+void Stats::dumpCounters(FILE *out, bool json) const {
+  if (json) {
+    fprintf(out, "{");
+  }
+  for (size_t i = 0; i < sizeof(counters_info) / sizeof(counters_info[0]);
+       ++i) {
+    const unsigned long long value = io_counters.*counters_info[i].value;
+    if (json) {
+      fprintf(out, "%s\"%s\": %llu", i ? ", " : "", counters_info[i].name,
+              value);
+    } else {
+      fprintf(out, "%-20s %llu\n", counters_info[i].name, value);
+    }
+  }
+  if (json) {
+    fprintf(out, "}\n");
+  }
+  fflush(out);
+}
+
+const std::map<std::string, Histogram> &Stats::getHistograms() const {
+  return histograms;
+}
+
+void Stats::writeFile(const std::string &path,
+                      std::function<void(FILE *out)> write) {
+  // Readers never see partially written file
+  const std::string tmp_path = path + ".tmp";
+  FILE *out = fopen(tmp_path.c_str(), "w");
+  if (!out) {
+    std::ostringstream err;
+    err << "Can't open " << tmp_path << ": " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+  write(out);
+  if ((fclose(out) == EOF) || rename(tmp_path.c_str(), path.c_str())) {
+    std::ostringstream err;
+    err << "Can't write " << path << ": " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+}
+
+// Output of terminal is written by curses, so the only way to count it
+// without wrapping output is kernel counter of bytes written by process
+bool Stats::readBytesWritten(uint64_t &bytes) {
+  FILE *io = fopen("/proc/self/io", "r");
+  if (!io) {
+    return false;
+  }
+
+  char name[32];
+  unsigned long long value;
+  bool found = false;
+  while (fscanf(io, "%31[^:]: %llu\n", name, &value) == 2) {
+    if (!strcmp(name, "wchar")) {
+      bytes = value;
+      found = true;
+      break;
+    }
+  }
+  fclose(io);
+  return found;
+}
+
+bool Stats::readResidentMemory(uint64_t &bytes) {
+  FILE *statm = fopen("/proc/self/statm", "r");
+  if (!statm) {
+    return false;
+  }
+
+  unsigned long long size, resident;
+  const bool found = fscanf(statm, "%llu %llu", &size, &resident) == 2;
+  fclose(statm);
+  if (found) {
+    bytes = resident * sysconf(_SC_PAGESIZE);
+  }
+  return found;
+}
+
+uint64_t Stats::now() {
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (static_cast<uint64_t>(time.tv_sec) * 1000000000) + time.tv_nsec;
+}
+
+StatsTimer::StatsTimer(Histogram *histogram)
+    : histogram(histogram), start(histogram ? Stats::now() : 0) {}
+
+StatsTimer::~StatsTimer() {
+  if (histogram) {
+    histogram->record(Stats::now() - start);
+  }
+}
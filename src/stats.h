@@ -0,0 +1,111 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <ev++.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include "alloc_counter.h"
+#include "histogram.h"
+#include "hud.h"
+#include "io_counters.h"
+#include "perf_counters.h"
+#include "trace.h"
+
+class Config;
+
+// Collects timings of program stages when --stats or --metrics-file is
+// specified and trace events when --trace is specified
+class Stats {
+ public:
+  Stats(const Config &config);
+  ~Stats();
+  // Returns nullptr if statistics are not collected, so callers can skip
+  // time measurement. Deadline is in nanoseconds.
+  Histogram *getHistogram(const std::string &name, uint64_t deadline = 0);
+  // Returns nullptr if statistics are not collected or hardware counters
+  // are not available
+  PerfTotals *getPerfTotals(const std::string &name);
+  // Returns nullptr if statistics are not collected or mattext is built
+  // without allocation counter
+  AllocTotals *getAllocTotals(const std::string &name);
+  // Returns nullptr if trace is not written
+  Trace *getTrace();
+  IoCounters &getIoCounters();
+  const IoCounters &getIoCounters() const;
+  Hud &getHud();
+  // Prints report to the file from config or to stderr
+  void report() const;
+  void report(FILE *out) const;
+  // Dumps counters on SIGUSR1 while event loop is running. When stderr is
+  // covered by screen and no file is given, they go to a file in temporary
+  // directory.
+  void watchCounters(bool screen_on_stderr);
+  // Writes counters to the file from config or to stderr, file is replaced
+  // atomically
+  void dumpCounters() const;
+  // Prints path of the file chosen by watchCounters() if counters were
+  // written to it
+  void reportCountersFile() const;
+  void dumpCounters(FILE *out, bool json) const;
+  const std::map<std::string, Histogram> &getHistograms() const;
+  // Replaces file atomically with data written by write callback
+  static void writeFile(const std::string &path,
+                        std::function<void(FILE *out)> write);
+  // Total number of bytes written by process, returns false if it is not
+  // known
+  static bool readBytesWritten(uint64_t &bytes);
+  static bool readResidentMemory(uint64_t &bytes);
+  // Monotonic time in nanoseconds
+  static uint64_t now();
+
+ private:
+  const Config &config;
+  std::map<std::string, Histogram> histograms;
+  std::unique_ptr<PerfCounters> perf_counters;
+  std::map<std::string, PerfTotals> perf_totals;
+  std::map<std::string, AllocTotals> alloc_totals;
+  std::unique_ptr<Trace> trace;
+  IoCounters io_counters;
+  Hud hud;
+  ev::sig sig_watcher;
+  std::string signal_counters_file;
+  bool signal_counters_written = false;
+
+  void signalCb(ev::sig &w, int revents);
+  void dumpCounters(const std::string &path) const;
+};
+
+// Records time from construction to destruction into histogram
+class StatsTimer {
+ public:
+  StatsTimer(Histogram *histogram);
+  ~StatsTimer();
+
+ private:
+  Histogram *histogram;
+  uint64_t start;
+};
@@ -0,0 +1,38 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <wchar.h>
+
+// Longest multibyte symbol that is decoded
+static const size_t mbchar_size = 4;
+
+// Source of decoded symbols for page layout
+class SymbolInput {
+ public:
+  enum class Status { Ok, End, WouldBlock };
+  virtual ~SymbolInput() = default;
+  virtual Status read(wchar_t &symbol) = 0;
+  // Steps back by one byte
+  virtual void unread() = 0;
+};
@@ -19,89 +19,20 @@ Mattext is distributed in the hope that it will be useful,
 
 *******************************************************************************/
 
-#define _XOPEN_SOURCE_EXTENDED
 #include "terminal.h"
-#include <assert.h>
-#include <curses.h>
-#include <fcntl.h>
-#include <string.h>
-#include <sys/ioctl.h>
-#include <unistd.h>
-#include <sstream>
-#include <stdexcept>
-#include <vector>
-#include "config.h"
-
-Terminal::Terminal(const Config &config)
-    : colors{COLOR_BLACK, COLOR_RED,     COLOR_GREEN, COLOR_YELLOW,
-             COLOR_BLUE,  COLOR_MAGENTA, COLOR_CYAN,  COLOR_WHITE} {
-  if (!isatty(STDOUT_FILENO)) {
-    struct winsize w_size;
-    if (ioctl(0, TIOCGWINSZ, &w_size) == -1) {
-      std::ostringstream err;
-      err << "Can't get terminal size via ioctl: " << strerror(errno);
-      throw std::runtime_error(err.str());
-    }
-    stdout_is_tty = false;
-    width = w_size.ws_col;
-    height = w_size.ws_row;
-
-    return;
-  }
-
-  tty_fd = open("/dev/tty", O_RDONLY | O_NONBLOCK);
-  if (tty_fd == -1) {
-    std::ostringstream err;
-    err << "Can't open file '/dev/tty': " << strerror(errno);
-    throw std::runtime_error(err.str());
-  }
-
-  if (!isatty(STDIN_FILENO)) {
-    stdin_fd = dup(STDIN_FILENO);
-    if ((stdin_fd == -1) || (dup2(tty_fd, STDIN_FILENO) == -1)) {
-      std::ostringstream err;
-      err << "Can't redirect stdin to '/dev/tty': " << strerror(errno);
-      throw std::runtime_error(err.str());
-    }
-    stdin_is_tty = false;
-  }
-
-  initscr();
-  getmaxyx(stdscr, height, width);
-  noecho();
-  cbreak();
-  curs_set(0);
-  keypad(stdscr, true);
-
-  if (has_colors() && config.use_colors) {
-    use_colors = true;
-    start_color();
-    use_default_colors();
-
-    // Workaround for a bug in old ncurses versions, bkgd does not work if
-    // called right after use_default_colors.
-    refresh();
-
-    color_pairs[std::make_pair(default_fg, default_bg)] = 0;
-  }
-  onKeyPress([this](int cmd) {
-    if (cmd == KEY_RESIZE) {
-      getmaxyx(stdscr, height, width);
-    }
-  });
-}
-
-Terminal::~Terminal() {
-  if (stdout_is_tty) {
-    endwin();
-  }
-  if (!stdin_is_tty) {
-    close(stdin_fd);
-  } else {
-    close(tty_fd);
-  }
-  stop();
-}
+#include <algorithm>
+#include "hud.h"
+#include "perf_counters.h"
+#include "stats.h"
+#include "text_grid.h"
+#include "trace.h"
+
+Terminal::Terminal(Stats &stats)
+    : stats(stats),
+      show_time(stats.getHistogram("show")),
+      flush_perf(stats.getPerfTotals("flush")),
+      trace(stats.getTrace()),
+      hud(stats.getHud()) {}
 
 size_t Terminal::getWidth() const {
   return width;
@@ -119,110 +50,70 @@ bool Terminal::stdinIsTty() const {
   return stdin_is_tty;
 }
 
-short Terminal::getColor(short color) const {
-  if ((color < 0) || (static_cast<size_t>(color) >= colors.size())) {
-    throw std::runtime_error(
-        "Can't add another color, maximum number was reached");
-  }
-  return colors[color];
+int Terminal::stdinFd() const {
+  return stdin_fd;
 }
 
-short Terminal::getColorPair(short fg, short bg) const {
-  short color_pair;
-
-  if (fg == ColorDefault) {
-    fg = default_fg;
-  } else {
-    fg = getColor(fg);
-  }
-  if (bg == ColorDefault) {
-    bg = default_bg;
-  } else {
-    bg = getColor(bg);
+void Terminal::blitText(const TextGrid &grid, int column, int row,
+                        int rect_width, int rect_height, bool bold, int fg,
+                        int bg) const {
+  if (!clip(column, row, rect_width, rect_height)) {
+    return;
   }
-  try {
-    color_pair = color_pairs.at(std::make_pair(fg, bg));
-  } catch (std::out_of_range) {
-    color_pair = color_pairs.size();
-    if (color_pair >= COLOR_PAIRS) {
-      throw std::runtime_error(
-          "Can't add another color pair, maximum number was reached");
+  const int grid_width = grid.getWidth();
+  const int grid_height = grid.getHeight();
+  const int end_column = column + rect_width;
+  const int end_row = row + rect_height;
+  const int text_end_column = std::min(end_column, grid_width);
+  const int text_end_row = std::min(end_row, grid_height);
+
+  if (column < text_end_column) {
+    const int count = text_end_column - column;
+    row_symbols.resize(count);
+    for (int y = row; y < text_end_row; ++y) {
+      grid.getRow(column, y, count, row_symbols.data());
+      setRow(column, y, row_symbols.data(), count, bold, fg, bg);
     }
-    init_pair(color_pair, fg, bg);
-    color_pairs[std::make_pair(fg, bg)] = color_pair;
   }
-
-  return color_pair;
-}
-
-void Terminal::set(int column, int row, wchar_t symbol, bool bold, short fg,
-                   short bg) const {
-  assert(stdout_is_tty);
-  if ((column < 0) || (column >= width) || (row < 0) || (row >= height)) {
-    return;
+  const int space_column = std::max(column, text_end_column);
+  if (space_column < end_column) {
+    fillRect(space_column, row, end_column - space_column,
+             std::max(text_end_row - row, 0), L' ', bold, fg, bg);
   }
-  wchar_t str[] = {symbol, L'\0'};
-  cchar_t cchar;
-  attr_t attr = bold ? A_BOLD : A_NORMAL;
-  short color_pair = 0;
-
-  if (use_colors) {
-    color_pair = getColorPair(fg, bg);
+  if (text_end_row < end_row) {
+    const int space_row = std::max(row, text_end_row);
+    fillRect(column, space_row, rect_width, end_row - space_row, L' ', bold,
+             fg, bg);
   }
-
-  setcchar(&cchar, str, attr, color_pair, nullptr);
-  mvadd_wch(row, column, &cchar);
-}
-
-wchar_t Terminal::get(int column, int row) const {
-  assert(stdout_is_tty);
-  cchar_t cchar;
-
-  mvin_wch(row, column, &cchar);
-
-  std::vector<wchar_t> str(
-      getcchar(&cchar, nullptr, nullptr, nullptr, nullptr));
-  attr_t attr;
-  short color_pair;
-
-  getcchar(&cchar, str.data(), &attr, &color_pair, nullptr);
-
-  return str[0];
 }
 
-void Terminal::setColors(short fg, short bg) const {
-  assert(stdout_is_tty);
-  if (!use_colors) {
-    return;
+bool Terminal::clip(int &column, int &row, int &rect_width,
+                    int &rect_height) const {
+  if (column < 0) {
+    rect_width += column;
+    column = 0;
   }
-
-  bkgd(COLOR_PAIR(getColorPair(fg, bg)));
-  show();
+  if (row < 0) {
+    rect_height += row;
+    row = 0;
+  }
+  rect_width = std::min(rect_width, width - column);
+  rect_height = std::min(rect_height, height - row);
+  return (rect_width > 0) && (rect_height > 0);
 }
 
 void Terminal::show() const {
-  assert(stdout_is_tty);
-  refresh();
-}
-
-void Terminal::clear() const {
-  assert(stdout_is_tty);
-  erase();
+  StatsTimer timer(show_time);
+  hud.frameShown();
+  TraceEvent event(trace, "show");
+  event.arg("cells", cells_changed);
+  cells_changed = 0;
+  PerfScope perf(flush_perf);
+  flush();
 }
 
-int Terminal::stdinFd() const {
-  return stdin_fd;
-}
-
-void Terminal::stop() const {
-  io_watcher.stop();
-}
-
-void Terminal::inputCb(ev::io & /*w*/, int /*revents*/) {
-  int key = getch();
-  for (const auto &cb : on_key_press) {
-    cb(key);
-  }
+void Terminal::showOverlay() const {
+  flush();
 }
 
 void Terminal::onKeyPress(std::function<void(int)> _on_key_press) const {
@@ -230,8 +121,15 @@ void Terminal::onKeyPress(std::function<void(int)> _on_key_press) const {
     return;
   }
   if (on_key_press.empty()) {
-    io_watcher.set<Terminal, &Terminal::inputCb>(const_cast<Terminal *>(this));
-    io_watcher.start(tty_fd, ev::READ);
+    startInput();
   }
   on_key_press.push_back(_on_key_press);
 }
+
+void Terminal::keyPressed(int key) const {
+  TraceEvent event(trace, "key");
+  event.arg("key", key);
+  for (const auto &cb : on_key_press) {
+    cb(key);
+  }
+}
@@ -21,13 +21,16 @@ Mattext is distributed in the hope that it will be useful,
 
 #pragma once
 
-#include <ev++.h>
 #include <unistd.h>
 #include <functional>
-#include <map>
 #include <vector>
 
-class Config;
+class Histogram;
+class Hud;
+class Stats;
+class TextGrid;
+class Trace;
+struct PerfTotals;
 
 enum Colors {
   ColorDefault = -1,
@@ -41,40 +44,74 @@ enum Colors {
   ColorWhite
 };
 
+// Colors from 8 to 255 are the rest of the 256-color palette, 24-bit colors
+// are made by rgbColor(). Colors a terminal can't show are replaced with the
+// closest ones it can.
+const int PaletteSize = 256;
+const int ColorRgb = 1 << 24;
+
+inline int rgbColor(int red, int green, int blue) {
+  return ColorRgb | ((red & 0xff) << 16) | ((green & 0xff) << 8)
+         | (blue & 0xff);
+}
+
 class Terminal {
  public:
-  Terminal(const Config &config);
-  ~Terminal();
+  Terminal(Stats &stats);
+  virtual ~Terminal() = default;
   size_t getWidth() const;
   size_t getHeight() const;
   bool stdoutIsTty() const;
   bool stdinIsTty() const;
-  void set(int column, int row, wchar_t symbol, bool bold = false,
-           short fg = ColorDefault, short bg = ColorDefault) const;
-  wchar_t get(int column, int row) const;
-  void setColors(short fg, short bg) const;
-  void show() const;
-  void clear() const;
   int stdinFd() const;
   void onKeyPress(std::function<void(int)> on_key) const;
-  void stop() const;
+  virtual void set(int column, int row, wchar_t symbol, bool bold = false,
+                   int fg = ColorDefault, int bg = ColorDefault) const = 0;
+  // Span operations clip and resolve attributes once per call instead of
+  // once per cell
+  virtual void setRow(int column, int row, const wchar_t *symbols, int count,
+                      bool bold = false, int fg = ColorDefault,
+                      int bg = ColorDefault) const = 0;
+  virtual void fillRect(int column, int row, int rect_width, int rect_height,
+                        wchar_t symbol, bool bold = false,
+                        int fg = ColorDefault,
+                        int bg = ColorDefault) const = 0;
+  // Copies the rectangle of grid to the same position on screen, cells out
+  // of grid are filled with spaces
+  void blitText(const TextGrid &grid, int column, int row, int rect_width,
+                int rect_height, bool bold = false, int fg = ColorDefault,
+                int bg = ColorDefault) const;
+  virtual wchar_t get(int column, int row) const = 0;
+  virtual void setColors(int fg, int bg) const = 0;
+  void show() const;
+  // Updates screen without counting it as a frame, overlays use it to show
+  // changes between animation frames
+  void showOverlay() const;
+  virtual void clear() const = 0;
+  virtual void stop() const = 0;
 
- private:
-  int width;
-  int height;
+ protected:
+  int width = 0;
+  int height = 0;
   bool stdout_is_tty = true;
   bool stdin_is_tty = true;
-  bool use_colors = false;
-  short default_fg = -1;
-  short default_bg = -1;
-  std::vector<short> colors;
-  mutable std::map<std::pair<short, short>, short> color_pairs;
-  int tty_fd;
   int stdin_fd = STDIN_FILENO;
-  mutable ev::io io_watcher;
-  mutable std::vector<std::function<void(int)>> on_key_press;
+  Stats &stats;
+  // Is increased by set(), is reset when screen is updated
+  mutable size_t cells_changed = 0;
+
+  virtual void flush() const = 0;
+  virtual void startInput() const = 0;
+  // Shrinks the rectangle to the screen, returns false if nothing is left
+  bool clip(int &column, int &row, int &rect_width, int &rect_height) const;
+  void keyPressed(int key) const;
 
-  short getColor(short color) const;
-  short getColorPair(short fg, short bg) const;
-  void inputCb(ev::io &w, int revents);
+ private:
+  mutable std::vector<std::function<void(int)>> on_key_press;
+  // Symbols of grid row decoded by blitText()
+  mutable std::vector<wchar_t> row_symbols;
+  Histogram *show_time;
+  PerfTotals *flush_perf;
+  Trace *trace;
+  Hud &hud;
 };
@@ -0,0 +1,352 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#define _XOPEN_SOURCE_EXTENDED
+#include "terminal_curses.h"
+#include <assert.h>
+#include <curses.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include "config.h"
+#include "palette.h"
+
+// Colors are placed in rgb_cache by the top bits of Fibonacci hash
+static const int rgb_cache_bits = 12;
+static const size_t rgb_cache_size = 1 << rgb_cache_bits;
+
+CursesTerminal::CursesTerminal(const Config &config, Stats &stats)
+    : Terminal(stats) {
+  if (!isatty(STDOUT_FILENO)) {
+    stdout_is_tty = false;
+    stdin_is_tty = isatty(STDIN_FILENO);
+    // Given width makes plain mode usable without terminal
+    if (config.width > 0) {
+      width = config.width;
+      height = (config.height > 0) ? config.height : DEFAULT_HEIGHT;
+      return;
+    }
+
+    struct winsize w_size;
+    if (ioctl(0, TIOCGWINSZ, &w_size) == -1) {
+      std::ostringstream err;
+      err << "Can't get terminal size via ioctl: " << strerror(errno);
+      throw std::runtime_error(err.str());
+    }
+    width = w_size.ws_col;
+    height = (config.height > 0) ? config.height : w_size.ws_row;
+
+    return;
+  }
+
+  tty_fd = open("/dev/tty", O_RDONLY | O_NONBLOCK);
+  if (tty_fd == -1) {
+    std::ostringstream err;
+    err << "Can't open file '/dev/tty': " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+
+  if (!isatty(STDIN_FILENO)) {
+    stdin_fd = dup(STDIN_FILENO);
+    if ((stdin_fd == -1) || (dup2(tty_fd, STDIN_FILENO) == -1)) {
+      std::ostringstream err;
+      err << "Can't redirect stdin to '/dev/tty': " << strerror(errno);
+      throw std::runtime_error(err.str());
+    }
+    stdin_is_tty = false;
+  }
+
+  initscr();
+  getmaxyx(stdscr, height, width);
+  noecho();
+  cbreak();
+  curs_set(0);
+  keypad(stdscr, true);
+
+  if (has_colors() && config.use_colors) {
+    use_colors = true;
+    start_color();
+    use_default_colors();
+
+    // Workaround for a bug in old ncurses versions, bkgd does not work if
+    // called right after use_default_colors.
+    refresh();
+
+    palette_size = std::min(COLORS, PaletteSize);
+    palette_map.resize(PaletteSize);
+    for (int i = 0; i < PaletteSize; ++i) {
+      palette_map[i] =
+          (i < palette_size) ? i
+                             : nearestPaletteColor(paletteRgb(i), palette_size);
+    }
+    // init_pair() and cchar_t take pair as short
+    max_pairs = std::min(COLOR_PAIRS, SHRT_MAX + 1);
+    pair_table.assign((PaletteSize + 1) * (PaletteSize + 1), -1);
+    pair_table[0] = 0;
+    pair_colors.push_back(0);
+    pair_used.push_back(frame);
+    rgb_cache.resize(rgb_cache_size);
+  }
+  onKeyPress([this](int cmd) {
+    if (cmd == KEY_RESIZE) {
+      getmaxyx(stdscr, height, width);
+    }
+  });
+}
+
+CursesTerminal::~CursesTerminal() {
+  if (stdout_is_tty) {
+    endwin();
+  }
+  if (!stdin_is_tty) {
+    close(stdin_fd);
+  } else {
+    close(tty_fd);
+  }
+  stop();
+}
+
+// Index of color in pair_table, 0 is the default color
+int CursesTerminal::colorIndex(int color) const {
+  if (color == ColorDefault) {
+    return 0;
+  }
+  if ((color & ~0xffffff) == ColorRgb) {
+    const int rgb = color & 0xffffff;
+    RgbIndex &cached = rgb_cache[(static_cast<uint32_t>(rgb) * 2654435761u)
+                                 >> (32 - rgb_cache_bits)];
+    if (cached.rgb != rgb) {
+      cached.rgb = rgb;
+      cached.index = nearestPaletteColor(rgb, palette_size) + 1;
+    }
+    return cached.index;
+  }
+  if ((color < 0) || (color >= PaletteSize)) {
+    std::ostringstream err;
+    err << "Unknown color " << color;
+    throw std::runtime_error(err.str());
+  }
+  return palette_map[color] + 1;
+}
+
+short CursesTerminal::cursesColor(int index, short default_color) const {
+  return index ? index - 1 : default_color;
+}
+
+short CursesTerminal::getColorPair(int fg, int bg) const {
+  const int index = colorIndex(fg) * (PaletteSize + 1) + colorIndex(bg);
+  short color_pair = pair_table[index];
+
+  if (color_pair < 0) {
+    color_pair = allocColorPair(index);
+  }
+  pair_used[color_pair] = frame;
+  return color_pair;
+}
+
+// Takes a free pair or, when all pairs are taken, the least recently used
+// one. Cells already drawn with a reused pair change their colors too, so
+// pairs used in the current frame are never reused, the nearest of them is
+// shown instead.
+short CursesTerminal::allocColorPair(int index) const {
+  short color_pair = 0;
+
+  if (pair_colors.size() < static_cast<size_t>(max_pairs)) {
+    color_pair = pair_colors.size();
+    pair_colors.push_back(index);
+    pair_used.push_back(frame);
+  } else {
+    // Pair 0 always has default colors
+    for (size_t i = 1; i < pair_colors.size(); ++i) {
+      if ((static_cast<short>(i) != background_pair)
+          && (pair_used[i] != frame)
+          && (!color_pair || (pair_used[i] < pair_used[color_pair]))) {
+        color_pair = i;
+      }
+    }
+    if (!color_pair) {
+      return nearestColorPair(index);
+    }
+    pair_table[pair_colors[color_pair]] = -1;
+    pair_colors[color_pair] = index;
+  }
+  init_pair(color_pair, cursesColor(index / (PaletteSize + 1), default_fg),
+            cursesColor(index % (PaletteSize + 1), default_bg));
+  pair_table[index] = color_pair;
+
+  return color_pair;
+}
+
+// Allocated pair with colors closest to the colors of index, it is not
+// remembered in pair_table, so the colors get their own pair once one is
+// free
+short CursesTerminal::nearestColorPair(int index) const {
+  short color_pair = 0;
+  int min_distance = -1;
+
+  for (size_t i = 0; i < pair_colors.size(); ++i) {
+    const int distance = pairDistance(pair_colors[i] / (PaletteSize + 1),
+                                      index / (PaletteSize + 1))
+                         + pairDistance(pair_colors[i] % (PaletteSize + 1),
+                                        index % (PaletteSize + 1));
+    if ((min_distance < 0) || (distance < min_distance)) {
+      color_pair = i;
+      min_distance = distance;
+    }
+  }
+  return color_pair;
+}
+
+// Distance between colors given by colorIndex(), colors of the terminal
+// itself are farther than any palette color
+int CursesTerminal::pairDistance(int color_1, int color_2) const {
+  if (color_1 == color_2) {
+    return 0;
+  }
+  if (!color_1 || !color_2) {
+    return colorDistance(0, 0xffffff) + 1;
+  }
+  return colorDistance(paletteRgb(color_1 - 1), paletteRgb(color_2 - 1));
+}
+
+void CursesTerminal::set(int column, int row, wchar_t symbol, bool bold,
+                         int fg, int bg) const {
+  assert(stdout_is_tty);
+  if ((column < 0) || (column >= width) || (row < 0) || (row >= height)) {
+    return;
+  }
+  wchar_t str[] = {symbol, L'\0'};
+  cchar_t cchar;
+  attr_t attr = bold ? A_BOLD : A_NORMAL;
+  short color_pair = 0;
+
+  if (use_colors) {
+    color_pair = getColorPair(fg, bg);
+  }
+
+  setcchar(&cchar, str, attr, color_pair, nullptr);
+  mvadd_wch(row, column, &cchar);
+  ++cells_changed;
+}
+
+void CursesTerminal::setRow(int column, int row, const wchar_t *symbols,
+                            int count, bool bold, int fg, int bg) const {
+  assert(stdout_is_tty);
+  int rect_height = 1;
+  const int first_column = column;
+  if (!clip(column, row, count, rect_height)) {
+    return;
+  }
+  symbols += column - first_column;
+  wchar_t str[] = {L'\0', L'\0'};
+  cchar_t cchar;
+  attr_t attr = bold ? A_BOLD : A_NORMAL;
+  short color_pair = use_colors ? getColorPair(fg, bg) : 0;
+
+  for (int i = 0; i < count; ++i) {
+    str[0] = symbols[i];
+    setcchar(&cchar, str, attr, color_pair, nullptr);
+    mvadd_wch(row, column + i, &cchar);
+  }
+  cells_changed += count;
+}
+
+void CursesTerminal::fillRect(int column, int row, int rect_width,
+                              int rect_height, wchar_t symbol, bool bold,
+                              int fg, int bg) const {
+  assert(stdout_is_tty);
+  if (!clip(column, row, rect_width, rect_height)) {
+    return;
+  }
+  wchar_t str[] = {symbol, L'\0'};
+  cchar_t cchar;
+  attr_t attr = bold ? A_BOLD : A_NORMAL;
+  short color_pair = use_colors ? getColorPair(fg, bg) : 0;
+
+  setcchar(&cchar, str, attr, color_pair, nullptr);
+  for (int y = row; y < row + rect_height; ++y) {
+    for (int x = column; x < column + rect_width; ++x) {
+      mvadd_wch(y, x, &cchar);
+    }
+  }
+  cells_changed += rect_width * rect_height;
+}
+
+wchar_t CursesTerminal::get(int column, int row) const {
+  assert(stdout_is_tty);
+  cchar_t cchar;
+
+  mvin_wch(row, column, &cchar);
+
+  wchar_t str[CCHARW_MAX + 1];
+  attr_t attr;
+  short color_pair;
+
+  getcchar(&cchar, str, &attr, &color_pair, nullptr);
+
+  return str[0];
+}
+
+void CursesTerminal::setColors(int fg, int bg) const {
+  assert(stdout_is_tty);
+  if (!use_colors) {
+    return;
+  }
+
+  // bkgd() takes only pairs below 256, pairs of cchar_t are not limited
+  background_pair = getColorPair(fg, bg);
+  wchar_t str[] = {L' ', L'\0'};
+  cchar_t cchar;
+  setcchar(&cchar, str, A_NORMAL, background_pair, nullptr);
+  bkgrnd(&cchar);
+  show();
+}
+
+void CursesTerminal::flush() const {
+  assert(stdout_is_tty);
+  refresh();
+  ++frame;
+}
+
+void CursesTerminal::clear() const {
+  assert(stdout_is_tty);
+  erase();
+}
+
+void CursesTerminal::stop() const {
+  io_watcher.stop();
+}
+
+void CursesTerminal::startInput() const {
+  io_watcher.set<CursesTerminal, &CursesTerminal::inputCb>(
+      const_cast<CursesTerminal *>(this));
+  io_watcher.start(tty_fd, ev::READ);
+}
+
+void CursesTerminal::inputCb(ev::io & /*w*/, int /*revents*/) {
+  keyPressed(getch());
+}
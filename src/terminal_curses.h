@@ -0,0 +1,83 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <ev++.h>
+#include <vector>
+#include "terminal.h"
+
+class Config;
+class Stats;
+
+class CursesTerminal : public Terminal {
+ public:
+  CursesTerminal(const Config &config, Stats &stats);
+  ~CursesTerminal();
+  void set(int column, int row, wchar_t symbol, bool bold = false,
+           int fg = ColorDefault, int bg = ColorDefault) const override;
+  void setRow(int column, int row, const wchar_t *symbols, int count,
+              bool bold = false, int fg = ColorDefault,
+              int bg = ColorDefault) const override;
+  void fillRect(int column, int row, int rect_width, int rect_height,
+                wchar_t symbol, bool bold = false, int fg = ColorDefault,
+                int bg = ColorDefault) const override;
+  wchar_t get(int column, int row) const override;
+  void setColors(int fg, int bg) const override;
+  void clear() const override;
+  void stop() const override;
+
+ private:
+  bool use_colors = false;
+  short default_fg = -1;
+  short default_bg = -1;
+  // Number of colors used from the palette, and terminal color shown for
+  // each palette color
+  int palette_size = 0;
+  std::vector<short> palette_map;
+  int max_pairs = 0;
+  // Pair of each (fg, bg) combination indexed by colorIndex(fg) *
+  // (PaletteSize + 1) + colorIndex(bg), -1 when no pair is allocated
+  mutable std::vector<short> pair_table;
+  // Index in pair_table and frame of last use of each allocated pair
+  mutable std::vector<int> pair_colors;
+  mutable std::vector<size_t> pair_used;
+  mutable size_t frame = 0;
+  mutable short background_pair = 0;
+  // Recently mapped 24-bit colors, each color has one place chosen by hash
+  struct RgbIndex {
+    int rgb = -1;
+    int index = 0;
+  };
+  mutable std::vector<RgbIndex> rgb_cache;
+  int tty_fd;
+  mutable ev::io io_watcher;
+
+  int colorIndex(int color) const;
+  short cursesColor(int index, short default_color) const;
+  short getColorPair(int fg, int bg) const;
+  short allocColorPair(int index) const;
+  short nearestColorPair(int index) const;
+  int pairDistance(int color_1, int color_2) const;
+  void flush() const override;
+  void startInput() const override;
+  void inputCb(ev::io &w, int revents);
+};
@@ -0,0 +1,119 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "terminal_headless.h"
+#include <algorithm>
+#include "config.h"
+
+HeadlessTerminal::HeadlessTerminal(const Config &config, Stats &stats)
+    : Terminal(stats) {
+  width = (config.width > 0) ? config.width : DEFAULT_WIDTH;
+  height = (config.height > 0) ? config.height : DEFAULT_HEIGHT;
+  stdout_is_tty = isatty(STDOUT_FILENO);
+  stdin_is_tty = isatty(STDIN_FILENO);
+  cells.resize(width * height);
+  clear();
+}
+
+void HeadlessTerminal::set(int column, int row, wchar_t symbol, bool bold,
+                           int fg, int bg) const {
+  if ((column < 0) || (column >= width) || (row < 0) || (row >= height)) {
+    return;
+  }
+  cells[row * width + column] = {symbol, bold, fg, bg};
+  ++cells_set;
+  ++cells_changed;
+}
+
+void HeadlessTerminal::setRow(int column, int row, const wchar_t *symbols,
+                              int count, bool bold, int fg, int bg) const {
+  int rect_height = 1;
+  const int first_column = column;
+  if (!clip(column, row, count, rect_height)) {
+    return;
+  }
+  symbols += column - first_column;
+  Cell *cell = &cells[row * width + column];
+  for (int i = 0; i < count; ++i) {
+    cell[i] = {symbols[i], bold, fg, bg};
+  }
+  cells_set += count;
+  cells_changed += count;
+}
+
+void HeadlessTerminal::fillRect(int column, int row, int rect_width,
+                                int rect_height, wchar_t symbol, bool bold,
+                                int fg, int bg) const {
+  if (!clip(column, row, rect_width, rect_height)) {
+    return;
+  }
+  for (int y = row; y < row + rect_height; ++y) {
+    std::fill_n(&cells[y * width + column], rect_width,
+                Cell{symbol, bold, fg, bg});
+  }
+  cells_set += rect_width * rect_height;
+  cells_changed += rect_width * rect_height;
+}
+
+wchar_t HeadlessTerminal::get(int column, int row) const {
+  if ((column < 0) || (column >= width) || (row < 0) || (row >= height)) {
+    return L' ';
+  }
+  return cells[row * width + column].symbol;
+}
+
+void HeadlessTerminal::setColors(int fg, int bg) const {
+  default_fg = fg;
+  default_bg = bg;
+}
+
+void HeadlessTerminal::flush() const {
+  ++frames_shown;
+  if (on_show) {
+    on_show();
+  }
+}
+
+void HeadlessTerminal::clear() const {
+  for (auto &cell : cells) {
+    cell = {L' ', false, default_fg, default_bg};
+  }
+}
+
+void HeadlessTerminal::stop() const {}
+
+void HeadlessTerminal::press(int key) const {
+  keyPressed(key);
+}
+
+void HeadlessTerminal::onShow(std::function<void()> _on_show) const {
+  on_show = _on_show;
+}
+
+size_t HeadlessTerminal::framesShown() const {
+  return frames_shown;
+}
+
+size_t HeadlessTerminal::cellsSet() const {
+  return cells_set;
+}
+
+void HeadlessTerminal::startInput() const {}
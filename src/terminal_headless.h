@@ -0,0 +1,68 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "terminal.h"
+
+class Config;
+class Stats;
+
+// Terminal that renders into memory, does not need a tty
+class HeadlessTerminal : public Terminal {
+ public:
+  HeadlessTerminal(const Config &config, Stats &stats);
+  void set(int column, int row, wchar_t symbol, bool bold = false,
+           int fg = ColorDefault, int bg = ColorDefault) const override;
+  void setRow(int column, int row, const wchar_t *symbols, int count,
+              bool bold = false, int fg = ColorDefault,
+              int bg = ColorDefault) const override;
+  void fillRect(int column, int row, int rect_width, int rect_height,
+                wchar_t symbol, bool bold = false, int fg = ColorDefault,
+                int bg = ColorDefault) const override;
+  wchar_t get(int column, int row) const override;
+  void setColors(int fg, int bg) const override;
+  void clear() const override;
+  void stop() const override;
+  void press(int key) const;
+  void onShow(std::function<void()> on_show) const;
+  size_t framesShown() const;
+  size_t cellsSet() const;
+
+ private:
+  struct Cell {
+    wchar_t symbol;
+    bool bold;
+    int fg;
+    int bg;
+  };
+  mutable std::vector<Cell> cells;
+  mutable int default_fg = ColorDefault;
+  mutable int default_bg = ColorDefault;
+  mutable size_t frames_shown = 0;
+  mutable size_t cells_set = 0;
+  mutable std::function<void()> on_show;
+
+  void flush() const override;
+  void startInput() const override;
+};
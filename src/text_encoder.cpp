@@ -0,0 +1,82 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "text_encoder.h"
+#include <langinfo.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+static const size_t utf8_max_size = 4;
+
+TextEncoder::TextEncoder()
+    : utf8(!strcmp(nl_langinfo(CODESET), "UTF-8")),
+      symbol_max_size(utf8 ? utf8_max_size : MB_LEN_MAX) {
+  memset(&state, 0, sizeof(state));
+}
+
+size_t TextEncoder::symbolMaxSize() const {
+  return symbol_max_size;
+}
+
+char *TextEncoder::encode(const wchar_t *str, size_t len, char *out) {
+  for (size_t i = 0; i < len; ++i) {
+    out = encode(str[i], out);
+  }
+  return out;
+}
+
+char *TextEncoder::encodeSymbol(wchar_t _symbol, char *out) {
+  const uint32_t symbol = static_cast<uint32_t>(_symbol);
+
+  if (!utf8) {
+    return encodeLocale(_symbol, out);
+  }
+  if (symbol < 0x800) {
+    *out++ = static_cast<char>(0xc0 | (symbol >> 6));
+    *out++ = static_cast<char>(0x80 | (symbol & 0x3f));
+  } else if ((symbol < 0x10000) && ((symbol < 0xd800) || (symbol > 0xdfff))) {
+    *out++ = static_cast<char>(0xe0 | (symbol >> 12));
+    *out++ = static_cast<char>(0x80 | ((symbol >> 6) & 0x3f));
+    *out++ = static_cast<char>(0x80 | (symbol & 0x3f));
+  } else if ((symbol >= 0x10000) && (symbol < 0x110000)) {
+    *out++ = static_cast<char>(0xf0 | (symbol >> 18));
+    *out++ = static_cast<char>(0x80 | ((symbol >> 12) & 0x3f));
+    *out++ = static_cast<char>(0x80 | ((symbol >> 6) & 0x3f));
+    *out++ = static_cast<char>(0x80 | (symbol & 0x3f));
+  } else {
+    // Surrogates and values out of unicode range
+    return encodeLocale(_symbol, out);
+  }
+  return out;
+}
+
+char *TextEncoder::encodeLocale(wchar_t symbol, char *out) {
+  const size_t len = wcrtomb(out, symbol, &state);
+  // Symbols missing in locale charset are replaced like glibc wide streams
+  // do it
+  if (len == static_cast<size_t>(-1)) {
+    memset(&state, 0, sizeof(state));
+    *out = '?';
+    return out + 1;
+  }
+  return out + len;
+}
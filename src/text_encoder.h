@@ -0,0 +1,53 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <wchar.h>
+
+// Encodes text to multibyte charset of current locale. Text is encoded to
+// UTF-8 directly when locale uses it, other locales go through wcrtomb().
+class TextEncoder {
+ public:
+  TextEncoder();
+  // Upper bound of encoded size of one symbol
+  size_t symbolMaxSize() const;
+  // Encodes len symbols to out, which has space for len * symbolMaxSize()
+  // bytes, returns end of encoded text
+  char *encode(const wchar_t *str, size_t len, char *out);
+  char *encode(wchar_t symbol, char *out) {
+    if (utf8 && (static_cast<uint32_t>(symbol) < 0x80)) {
+      *out = static_cast<char>(symbol);
+      return out + 1;
+    }
+    return encodeSymbol(symbol, out);
+  }
+
+ private:
+  bool utf8;
+  size_t symbol_max_size;
+  mbstate_t state;
+
+  char *encodeSymbol(wchar_t symbol, char *out);
+  char *encodeLocale(wchar_t symbol, char *out);
+};
@@ -0,0 +1,70 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <wchar.h>
+#include "page_buffer.h"
+
+// Symbols of page as they are shown on screen, with centering applied and
+// line ends replaced by spaces. Cells take 16 bits like in PageBuffer,
+// symbols out of the basic multilingual plane are found in its overflow
+// tables.
+class TextGrid {
+ public:
+  // Memory is allocated again only when size changes
+  void resize(size_t _width, size_t _height) {
+    width = _width;
+    height = _height;
+    cells.resize(height, width);
+    cells.clear();
+  }
+  size_t getWidth() const {
+    return width;
+  }
+  size_t getHeight() const {
+    return height;
+  }
+  // Symbols out of page are spaces
+  wchar_t get(size_t column, size_t row) const {
+    if ((column >= width) || (row >= height)) {
+      return L' ';
+    }
+    return cells.get(row, column);
+  }
+  // Symbols of row are set from left to right
+  void set(size_t column, size_t row, wchar_t symbol) {
+    cells.set(row, column, symbol);
+  }
+  // Decodes count symbols of row starting at column
+  void getRow(size_t column, size_t row, size_t count, wchar_t *out) const {
+    const PageBuffer::Cell *row_cells = cells.cells(row);
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = cells.get(row_cells, row, column + i);
+    }
+  }
+
+ private:
+  PageBuffer cells;
+  size_t width = 0;
+  size_t height = 0;
+};
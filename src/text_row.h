@@ -0,0 +1,67 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <wchar.h>
+#include "page_buffer.h"
+
+// Row of page that refers to text kept by reader, it is shown as padding
+// spaces followed by symbols
+struct TextRow {
+  size_t padding = 0;
+  const PageBuffer *page = nullptr;
+  const PageBuffer::Cell *cells = nullptr;
+  size_t row = 0;
+  // Column of page where row starts
+  size_t start = 0;
+  size_t size = 0;
+
+  TextRow() = default;
+  // Line wider than screen starts left of it, in negative column
+  TextRow(int start_column, const PageBuffer &_page, size_t _row, size_t _size)
+      : page(&_page), cells(_page.cells(_row)), row(_row), size(_size) {
+    if (start_column >= 0) {
+      padding = start_column;
+      return;
+    }
+    const size_t hidden = -start_column;
+    start = (hidden < size) ? hidden : size;
+    size -= start;
+  }
+
+  // Symbol of row without padding
+  wchar_t symbol(size_t id) const {
+    return page->get(cells, row, start + id);
+  }
+  // Symbol shown in column, line ends are shown as spaces
+  wchar_t get(size_t column) const {
+    if ((column < padding) || (column - padding >= size)) {
+      return L' ';
+    }
+    const wchar_t symbol = this->symbol(column - padding);
+    if ((symbol == '\n') || (symbol == '\r')) {
+      return L' ';
+    }
+    return symbol;
+  }
+};
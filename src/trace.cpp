@@ -0,0 +1,166 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "trace.h"
+#include <errno.h>
+#include <string.h>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include "stats.h"
+
+static size_t roundUpPow2(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+Trace::Trace(const std::string &path, size_t capacity)
+    : file(fopen(path.c_str(), "w")),
+      events(roundUpPow2(capacity)),
+      mask(events.size() - 1),
+      start_time(Stats::now()) {
+  if (!file) {
+    std::ostringstream err;
+    err << "Can't open trace file '" << path << "': " << strerror(errno);
+    throw std::runtime_error(err.str());
+  }
+  fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+  writer = std::thread([this]() { this->write(); });
+}
+
+Trace::~Trace() {
+  {
+    std::lock_guard<std::mutex> lock(stop_mutex);
+    stopping = true;
+  }
+  stop_cond.notify_one();
+  writer.join();
+  writeEvents();
+
+  fprintf(file,
+          "\n], \"otherData\": {\"written_events\": %zu, "
+          "\"dropped_events\": %zu}}\n",
+          written, dropped);
+  fclose(file);
+}
+
+void Trace::add(const Event &event) {
+  const size_t cur_head = head.load(std::memory_order_relaxed);
+  if (cur_head - tail.load(std::memory_order_acquire) > mask) {
+    ++dropped;
+    return;
+  }
+  events[cur_head & mask] = event;
+  head.store(cur_head + 1, std::memory_order_release);
+}
+
+void Trace::write() {
+  std::unique_lock<std::mutex> lock(stop_mutex);
+
+  while (!stopping) {
+    stop_cond.wait_for(lock, std::chrono::milliseconds(100));
+    lock.unlock();
+    writeEvents();
+    fflush(file);
+    lock.lock();
+  }
+}
+
+void Trace::writeEvents() {
+  const size_t cur_head = head.load(std::memory_order_acquire);
+  size_t cur_tail = tail.load(std::memory_order_relaxed);
+
+  for (; cur_tail != cur_head; ++cur_tail) {
+    writeEvent(events[cur_tail & mask]);
+    // Let producer reuse slot as soon as possible
+    tail.store(cur_tail + 1, std::memory_order_release);
+  }
+}
+
+static void writeString(FILE *file, const char *str) {
+  fputc('"', file);
+  for (; *str; ++str) {
+    const unsigned char c = *str;
+    if ((c == '"') || (c == '\\')) {
+      fputc('\\', file);
+      fputc(c, file);
+    } else if (c < 0x20) {
+      fprintf(file, "\\u%04x", c);
+    } else {
+      fputc(c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+void Trace::writeEvent(const Event &event) {
+  fprintf(file, "%s\n{\"name\": ", written ? "," : "");
+  writeString(file, event.name);
+  fprintf(file,
+          ", \"cat\": \"mattext\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, "
+          "\"ts\": %.3f, \"dur\": %.3f, \"args\": {",
+          (event.start - start_time) / 1e3, event.duration / 1e3);
+  for (int i = 0; (i < max_args) && event.args[i].name; ++i) {
+    fprintf(file, "%s\"%s\": ", i ? ", " : "", event.args[i].name);
+    if (event.args[i].str) {
+      writeString(file, event.args[i].str);
+    } else {
+      fprintf(file, "%lld", static_cast<long long>(event.args[i].value));
+    }
+  }
+  fprintf(file, "}}");
+  ++written;
+}
+
+TraceEvent::TraceEvent(Trace *trace, const char *name) : trace(trace) {
+  if (trace) {
+    strncpy(event.name, name, Trace::max_name_len);
+    event.start = Stats::now();
+  }
+}
+
+TraceEvent::~TraceEvent() {
+  if (trace) {
+    event.duration = Stats::now() - event.start;
+    trace->add(event);
+  }
+}
+
+void TraceEvent::arg(const char *name, int64_t value) {
+  if (trace && (args_num < Trace::max_args)) {
+    event.args[args_num].name = name;
+    event.args[args_num++].value = value;
+  }
+}
+
+void TraceEvent::arg(const char *name, const char *value) {
+  if (trace && (args_num < Trace::max_args)) {
+    event.args[args_num].name = name;
+    event.args[args_num++].str = value;
+  }
+}
+
+void TraceEvent::setStart(uint64_t start) {
+  event.start = start;
+}
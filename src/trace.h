@@ -0,0 +1,96 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes events in Chrome trace event format, which can be opened in
+// Perfetto or chrome://tracing. Events are put into preallocated ring by
+// event loop thread without locking and are written to file by separate
+// thread. Events are dropped if ring is full.
+class Trace {
+ public:
+  struct Arg {
+    // Name must not be freed while trace exists
+    const char *name = nullptr;
+    // String value is used if set, it must not be freed while trace exists
+    const char *str = nullptr;
+    int64_t value = 0;
+  };
+  static const int max_args = 4;
+  // Names are copied into events, as their owners can be destroyed before
+  // the rest of the ring is written, longer names are cut
+  static const size_t max_name_len = 31;
+  struct Event {
+    char name[max_name_len + 1] = {};
+    uint64_t start = 0;
+    uint64_t duration = 0;
+    Arg args[max_args];
+  };
+
+  Trace(const std::string &path, size_t capacity = 1 << 16);
+  ~Trace();
+  // Must be called from one thread only
+  void add(const Event &event);
+
+ private:
+  FILE *file;
+  std::vector<Event> events;
+  const size_t mask;
+  std::atomic<size_t> head{0};
+  std::atomic<size_t> tail{0};
+  size_t dropped = 0;
+  size_t written = 0;
+  const uint64_t start_time;
+  bool stopping = false;
+  std::mutex stop_mutex;
+  std::condition_variable stop_cond;
+  std::thread writer;
+
+  void write();
+  void writeEvents();
+  void writeEvent(const Event &event);
+};
+
+// Adds event with duration from construction to destruction to trace,
+// does nothing if trace is nullptr
+class TraceEvent {
+ public:
+  TraceEvent(Trace *trace, const char *name);
+  ~TraceEvent();
+  void arg(const char *name, int64_t value);
+  void arg(const char *name, const char *value);
+  // Moves start of event, for events which began before object creation
+  void setStart(uint64_t start);
+
+ private:
+  Trace *trace;
+  Trace::Event event;
+  int args_num = 0;
+};
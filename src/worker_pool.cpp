@@ -0,0 +1,121 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#include "worker_pool.h"
+#include <algorithm>
+
+// Every thread gets several chunks, so uneven chunks are balanced
+static const size_t chunks_per_thread = 4;
+
+WorkerPool::WorkerPool(size_t threads_num) {
+  if (!threads_num) {
+    threads_num = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (size_t i = 1; i < threads_num; ++i) {
+    threads.emplace_back(&WorkerPool::worker, this);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  start_cond.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+size_t WorkerPool::size() const {
+  return threads.size() + 1;
+}
+
+void WorkerPool::run(size_t _count, const Job &_job) {
+  if (!_count) {
+    return;
+  }
+  if (threads.empty() || (_count == 1)) {
+    _job(0, _count);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = &_job;
+    count = _count;
+    chunk_size = std::max<size_t>(1, count / (size() * chunks_per_thread));
+    chunks_num = (count + chunk_size - 1) / chunk_size;
+    next_chunk = 0;
+    chunks_done = 0;
+    ++generation;
+  }
+  start_cond.notify_all();
+
+  const size_t done = process();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  chunks_done += done;
+  done_cond.wait(lock, [this]() {
+    return (chunks_done == chunks_num) && !busy_threads;
+  });
+  job = nullptr;
+}
+
+void WorkerPool::worker() {
+  size_t seen_generation = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      start_cond.wait(lock, [this, seen_generation]() {
+        return stopping || (generation != seen_generation);
+      });
+      if (stopping) {
+        return;
+      }
+      seen_generation = generation;
+      ++busy_threads;
+    }
+
+    const size_t done = process();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      chunks_done += done;
+      --busy_threads;
+    }
+    done_cond.notify_one();
+  }
+}
+
+size_t WorkerPool::process() {
+  size_t done = 0;
+
+  while (true) {
+    const size_t chunk = next_chunk++;
+    if (chunk >= chunks_num) {
+      return done;
+    }
+    const size_t begin = chunk * chunk_size;
+    (*job)(begin, std::min(begin + chunk_size, count));
+    ++done;
+  }
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************
+
+Copyright 2015 Denis Tikhomirov
+
+This file is part of Mattext
+
+Mattext is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Mattext is distributed in the hope that it will be useful,
+     but WITHOUT ANY WARRANTY; without even the implied warranty of
+     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+     GNU General Public License for more details.
+
+     You should have received a copy of the GNU General Public License
+     along with Mattext.  If not, see http://www.gnu.org/licenses/.
+
+*******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+ public:
+  using Job = std::function<void(size_t begin, size_t end)>;
+
+  // threads_num includes calling thread, 0 means number of cores
+  WorkerPool(size_t threads_num = 0);
+  ~WorkerPool();
+  size_t size() const;
+  // Splits [0, count) into chunks and runs job on them in parallel, returns
+  // when all chunks are processed. Calling thread takes part in the work.
+  void run(size_t count, const Job &job);
+
+ private:
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable start_cond;
+  std::condition_variable done_cond;
+  const Job *job = nullptr;
+  size_t count = 0;
+  size_t chunk_size = 0;
+  size_t chunks_num = 0;
+  std::atomic<size_t> next_chunk{0};
+  size_t chunks_done = 0;
+  size_t generation = 0;
+  size_t busy_threads = 0;
+  bool stopping = false;
+
+  void worker();
+  size_t process();
+};